@@ -0,0 +1,37 @@
+#ifndef BENCHMARK_BENCHMARKUTILS_HPP_DEFINED
+#define BENCHMARK_BENCHMARKUTILS_HPP_DEFINED
+
+#include "utils/CoreUtils.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+namespace utymap { namespace benchmarks {
+
+class BenchmarkUtils
+{
+public:
+    /// Runs action given amount of times and returns elapsed time in microseconds.
+    template <typename Action>
+    static std::uint64_t run(std::size_t times, const Action& action)
+    {
+        return static_cast<std::uint64_t>(utymap::utils::measure<std::chrono::microseconds>::execution([&]() {
+            for (std::size_t i = 0; i < times; ++i)
+                action();
+        }));
+    }
+
+    /// Prints throughput for given amount of processed items.
+    static void report(const std::string& name, std::uint64_t items, std::uint64_t microseconds)
+    {
+        double seconds = microseconds > 0 ? microseconds / 1E6 : 1E-6;
+        std::cout << name << ": " << items << " items in " << microseconds / 1000 << " ms ("
+                  << static_cast<std::uint64_t>(items / seconds) << " items/s)" << std::endl;
+    }
+};
+
+}}
+
+#endif // BENCHMARK_BENCHMARKUTILS_HPP_DEFINED
@@ -0,0 +1,84 @@
+#include "builders/MeshBuilder.hpp"
+#include "heightmap/FlatElevationProvider.hpp"
+#include "utils/GeoUtils.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include "BenchmarkUtils.hpp"
+
+using namespace utymap;
+using namespace utymap::benchmarks;
+using namespace utymap::builders;
+using namespace utymap::heightmap;
+using namespace utymap::mapcss;
+using namespace utymap::math;
+
+namespace {
+    const std::size_t Iterations = 20;
+
+    struct Builders_MeshBuilderBenchmarkFixture
+    {
+        Builders_MeshBuilderBenchmarkFixture() :
+            quadKey(16, 35205, 21489),
+            bbox(utymap::utils::GeoUtils::quadKeyToBoundingBox(quadKey)),
+            builder(quadKey, eleProvider),
+            gradient(ColorGradient::GradientData { { 0, Color(0, 0, 0, 255) }, { 1, Color(255, 255, 255, 255) } }),
+            textureRegion(),
+            appearanceOptions(gradient, 0.1, 0, textureRegion, 1)
+        {
+        }
+
+        /// Creates polygon which covers whole tile except irregular hole like typical background region.
+        Polygon createPolygon() const
+        {
+            double x = bbox.minPoint.longitude, y = bbox.minPoint.latitude;
+            double w = bbox.width(), h = bbox.height();
+
+            Polygon polygon(12, 1);
+            polygon.addContour({ { x, y }, { x + w, y }, { x + w, y + h }, { x, y + h } });
+            polygon.addHole({ { x + 0.2 * w, y + 0.3 * h }, { x + 0.55 * w, y + 0.25 * h }, { x + 0.7 * w, y + 0.6 * h },
+                              { x + 0.45 * w, y + 0.5 * h }, { x + 0.3 * w, y + 0.75 * h } });
+            return polygon;
+        }
+
+        /// Builds polygon mesh with given max area relative to tile size and reports time.
+        std::size_t build(double relativeArea, bool useGrid, const std::string& name)
+        {
+            MeshBuilder::GeometryOptions geometryOptions(relativeArea * bbox.height() * bbox.height(),
+                                                         0.05, std::numeric_limits<double>::lowest(), 0, 1);
+            std::size_t triangles = 0;
+            auto time = BenchmarkUtils::run(Iterations, [&]() {
+                Mesh mesh("");
+                Polygon polygon = createPolygon();
+                if (useGrid)
+                    builder.addGrid(mesh, polygon, geometryOptions, appearanceOptions);
+                else
+                    builder.addPolygon(mesh, polygon, geometryOptions, appearanceOptions);
+                triangles = mesh.triangles.size() / 3;
+            });
+
+            BenchmarkUtils::report(name + ", triangles: " + std::to_string(triangles), Iterations, time);
+            return triangles;
+        }
+
+        QuadKey quadKey;
+        BoundingBox bbox;
+        FlatElevationProvider eleProvider;
+        MeshBuilder builder;
+        ColorGradient gradient;
+        TextureRegion textureRegion;
+        MeshBuilder::AppearanceOptions appearanceOptions;
+    };
+}
+
+BOOST_FIXTURE_TEST_SUITE(Builders_MeshBuilder, Builders_MeshBuilderBenchmarkFixture)
+
+BOOST_AUTO_TEST_CASE(GivenTileRegion_WhenBuildWithTriangleAndGrid_ThenReportTime)
+{
+    for (double relativeArea : { 0.002, 0.0005 }) {
+        std::string suffix = " max-area: " + std::to_string(relativeArea * 100) + "%";
+        BOOST_CHECK_GT(build(relativeArea, false, "MeshBuilder triangle" + suffix), 0);
+        BOOST_CHECK_GT(build(relativeArea, true, "MeshBuilder grid" + suffix), 0);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,96 @@
+#include "builders/QuadKeyBuilder.hpp"
+#include "builders/terrain/TerraBuilder.hpp"
+#include "index/GeoStore.hpp"
+#include "index/InMemoryElementStore.hpp"
+#include "mapcss/MapCssParser.hpp"
+#include "utils/GeoUtils.hpp"
+#include "utils/ThreadPool.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include "BenchmarkUtils.hpp"
+#include "config.hpp"
+#include "test_utils/DependencyProvider.hpp"
+
+#include <atomic>
+#include <fstream>
+#include <future>
+#include <thread>
+
+using namespace utymap;
+using namespace utymap::benchmarks;
+using namespace utymap::builders;
+using namespace utymap::index;
+using namespace utymap::mapcss;
+using namespace utymap::tests;
+using namespace utymap::utils;
+
+namespace {
+    const std::string InMemoryStoreKey = "InMemory";
+    const int LevelOfDetail = 1;
+    const std::size_t Iterations = 5;
+
+    struct Builders_QuadKeyBuilderBenchmarkFixture
+    {
+        Builders_QuadKeyBuilderBenchmarkFixture() :
+            geoStore(*dependencyProvider.getStringTable()),
+            quadKeyBuilder(geoStore, *dependencyProvider.getStringTable())
+        {
+            std::ifstream styleFile(TEST_MAPCSS_DEFAULT);
+            std::string stylePath = TEST_MAPCSS_DEFAULT;
+            MapCssParser parser(stylePath.substr(0, stylePath.find_last_of("\\/") + 1));
+            styleProvider = dependencyProvider.getStyleProvider(parser.parse(styleFile));
+
+            quadKeyBuilder.registerElementBuilder("terrain", [](const BuilderContext& context) {
+                return utymap::utils::make_unique<TerraBuilder>(context);
+            });
+
+            geoStore.registerStore(InMemoryStoreKey, utymap::utils::make_unique<InMemoryElementStore>(*dependencyProvider.getStringTable()));
+            LodRange range(LevelOfDetail, LevelOfDetail);
+            geoStore.add(InMemoryStoreKey, TEST_SHAPE_NE_110M_LAND, range, *styleProvider);
+            geoStore.add(InMemoryStoreKey, TEST_SHAPE_NE_110M_LAKES, range, *styleProvider);
+        }
+
+        /// Builds all tiles of benchmark level of detail using given amount of threads.
+        void build(std::size_t threads, const std::string& name)
+        {
+            std::vector<QuadKey> quadKeys;
+            GeoUtils::visitTileRange(BoundingBox(GeoCoordinate(-85, -180), GeoCoordinate(85, 180)), LevelOfDetail,
+                [&](const QuadKey& quadKey, const BoundingBox&) { quadKeys.push_back(quadKey); });
+
+            ThreadPool pool(threads);
+            std::atomic<std::uint64_t> meshes(0);
+            auto time = BenchmarkUtils::run(Iterations, [&]() {
+                std::vector<std::future<void>> results;
+                for (const auto& quadKey : quadKeys) {
+                    results.push_back(pool.enqueue([&, quadKey]() {
+                        quadKeyBuilder.build(quadKey, *styleProvider, *dependencyProvider.getElevationProvider(),
+                            [&](const utymap::math::Mesh&) { ++meshes; },
+                            [](const utymap::entities::Element&) {});
+                    }));
+                }
+                for (auto& result : results)
+                    result.get();
+            });
+
+            BenchmarkUtils::report(name, Iterations * quadKeys.size(), time);
+            BOOST_CHECK_GT(meshes.load(), 0);
+        }
+
+        DependencyProvider dependencyProvider;
+        std::shared_ptr<StyleProvider> styleProvider;
+        GeoStore geoStore;
+        QuadKeyBuilder quadKeyBuilder;
+    };
+}
+
+BOOST_FIXTURE_TEST_SUITE(Builders_QuadKeyBuilder, Builders_QuadKeyBuilderBenchmarkFixture)
+
+BOOST_AUTO_TEST_CASE(GivenNaturalEarthData_WhenBuildTilesConcurrently_ThenReportThroughput)
+{
+    std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+
+    build(1, "QuadKeyBuilder tiles, threads: 1");
+    build(threads, "QuadKeyBuilder tiles, threads: " + std::to_string(threads));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,119 @@
+#include "entities/Way.hpp"
+#include "index/PersistentElementStore.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include "BenchmarkUtils.hpp"
+#include "test_utils/DependencyProvider.hpp"
+#include "test_utils/ElementUtils.hpp"
+
+#include <boost/filesystem/operations.hpp>
+
+using namespace utymap;
+using namespace utymap::benchmarks;
+using namespace utymap::entities;
+using namespace utymap::index;
+using namespace utymap::tests;
+
+namespace {
+    const std::string TestZoomDirectory = "1";
+    const std::string Stylesheet = "way|z1[any] { clip: false; }";
+    const QuadKey TestQuadKey(1, 0, 0);
+
+    const std::size_t ElementCount = 20000;
+    const std::size_t GeometrySize = 10;
+    const std::size_t SearchTimes = 20;
+
+    struct ElementCounter : public ElementVisitor
+    {
+        std::uint64_t count = 0;
+
+        void visitNode(const Node&) override { ++count; }
+        void visitWay(const Way&) override { ++count; }
+        void visitArea(const Area&) override { ++count; }
+        void visitRelation(const Relation&) override { ++count; }
+    };
+
+    struct Index_PersistentElementStoreBenchmarkFixture
+    {
+        Index_PersistentElementStoreBenchmarkFixture()
+        {
+            boost::filesystem::create_directory(TestZoomDirectory);
+        }
+
+        ~Index_PersistentElementStoreBenchmarkFixture()
+        {
+            boost::filesystem::remove_all(TestZoomDirectory);
+            boost::filesystem::remove("manifest.idx");
+            boost::filesystem::remove("spatial.idf");
+            boost::filesystem::remove("spatial.dat");
+        }
+
+        /// Stores ways in all four tiles of first level of detail.
+        void store(const std::string& name)
+        {
+            auto& stringTable = *dependencyProvider.getStringTable();
+            auto styleProvider = dependencyProvider.getStyleProvider(Stylesheet);
+            PersistentElementStore elementStore("", stringTable);
+
+            std::vector<Way> ways;
+            ways.reserve(ElementCount);
+            for (std::size_t i = 0; i < ElementCount; ++i) {
+                Way way = ElementUtils::createElement<Way>(stringTable, i, { { "any", "true" }, { "highway", "residential" } });
+                double sign = i % 2 == 0 ? 1 : -1;
+                for (std::size_t j = 0; j < GeometrySize; ++j)
+                    way.coordinates.push_back(GeoCoordinate(1 + (i % 100) * 0.1 + j * 0.01, sign * (1 + j * 0.01)));
+                ways.push_back(way);
+            }
+
+            auto time = BenchmarkUtils::run(1, [&]() {
+                for (const auto& way : ways)
+                    elementStore.store(way, LodRange(1, 1), *styleProvider);
+                elementStore.commit();
+            });
+
+            BenchmarkUtils::report(name, ElementCount, time);
+
+            std::uintmax_t size = 0;
+            for (boost::filesystem::directory_iterator it(TestZoomDirectory), end; it != end; ++it)
+                size += boost::filesystem::file_size(it->path());
+            std::cout << name << ": " << size << " bytes on disk" << std::endl;
+        }
+
+        void search(PersistentElementStore::ReadMode readMode, const std::string& name)
+        {
+            PersistentElementStore elementStore("", *dependencyProvider.getStringTable(), readMode);
+            ElementCounter counter;
+
+            auto time = BenchmarkUtils::run(SearchTimes, [&]() {
+                elementStore.search(TestQuadKey, counter);
+            });
+            elementStore.commit();
+
+            BOOST_CHECK_EQUAL(counter.count, ElementCount / 2 * SearchTimes);
+            BenchmarkUtils::report(name, counter.count, time);
+        }
+
+        DependencyProvider dependencyProvider;
+    };
+}
+
+BOOST_FIXTURE_TEST_SUITE(Index_PersistentElementStore, Index_PersistentElementStoreBenchmarkFixture)
+
+BOOST_AUTO_TEST_CASE(GivenWays_WhenStore_ThenReportThroughput)
+{
+    store("PersistentElementStore store");
+}
+
+BOOST_AUTO_TEST_CASE(GivenStoredWays_WhenSearchWithStreamReadMode_ThenReportThroughput)
+{
+    store("PersistentElementStore store");
+    search(PersistentElementStore::ReadMode::Stream, "PersistentElementStore search (stream)");
+}
+
+BOOST_AUTO_TEST_CASE(GivenStoredWays_WhenSearchWithMappedReadMode_ThenReportThroughput)
+{
+    store("PersistentElementStore store");
+    search(PersistentElementStore::ReadMode::Mapped, "PersistentElementStore search (mapped)");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
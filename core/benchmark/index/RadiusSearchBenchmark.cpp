@@ -0,0 +1,157 @@
+#include "entities/Node.hpp"
+#include "index/InMemoryElementStore.hpp"
+#include "index/PersistentElementStore.hpp"
+#include "utils/GeoUtils.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include "BenchmarkUtils.hpp"
+#include "test_utils/DependencyProvider.hpp"
+#include "test_utils/ElementUtils.hpp"
+
+#include <boost/filesystem/operations.hpp>
+
+using namespace utymap;
+using namespace utymap::benchmarks;
+using namespace utymap::entities;
+using namespace utymap::index;
+using namespace utymap::tests;
+using namespace utymap::utils;
+
+namespace {
+    const int LevelOfDetail = 16;
+    const std::string TestZoomDirectory = "16";
+    const std::string Stylesheet = "node|z16[any] { clip: false; }";
+
+    const std::size_t GridSize = 150;
+    const double GridStep = 0.001;
+    const GeoCoordinate GridOrigin(52.45, 13.35);
+    const std::size_t QueryCount = 200;
+    const double Radius = 300;
+
+    /// Counts elements which are within radius from center.
+    struct DistanceCounter : public ElementVisitor
+    {
+        GeoCoordinate center;
+        std::uint64_t count = 0;
+
+        void visitNode(const Node& node) override
+        {
+            if (GeoUtils::distance(center, node.coordinate) <= Radius)
+                ++count;
+        }
+        void visitWay(const Way&) override { }
+        void visitArea(const Area&) override { }
+        void visitRelation(const Relation&) override { }
+    };
+
+    struct ElementCounter : public ElementVisitor
+    {
+        std::uint64_t count = 0;
+
+        void visitNode(const Node&) override { ++count; }
+        void visitWay(const Way&) override { ++count; }
+        void visitArea(const Area&) override { ++count; }
+        void visitRelation(const Relation&) override { ++count; }
+    };
+
+    struct Index_RadiusSearchBenchmarkFixture
+    {
+        Index_RadiusSearchBenchmarkFixture()
+        {
+            boost::filesystem::create_directory(TestZoomDirectory);
+        }
+
+        ~Index_RadiusSearchBenchmarkFixture()
+        {
+            boost::filesystem::remove_all(TestZoomDirectory);
+            boost::filesystem::remove("manifest.idx");
+            boost::filesystem::remove("spatial.idf");
+            boost::filesystem::remove("spatial.dat");
+        }
+
+        /// Stores nodes placed on regular grid.
+        void store(ElementStore& elementStore)
+        {
+            auto& stringTable = *dependencyProvider.getStringTable();
+            auto styleProvider = dependencyProvider.getStyleProvider(Stylesheet);
+            for (std::size_t i = 0; i < GridSize * GridSize; ++i) {
+                Node node = ElementUtils::createElement<Node>(stringTable, i + 1, { { "any", "true" } });
+                node.coordinate = GeoCoordinate(GridOrigin.latitude + (i / GridSize) * GridStep,
+                                                GridOrigin.longitude + (i % GridSize) * GridStep);
+                elementStore.store(node, LodRange(LevelOfDetail, LevelOfDetail), *styleProvider);
+            }
+            elementStore.commit();
+        }
+
+        /// Returns center of query with given index.
+        static GeoCoordinate getCenter(std::size_t index)
+        {
+            double extent = GridSize * GridStep;
+            return GeoCoordinate(GridOrigin.latitude + std::fmod(index * 0.37 * extent, extent),
+                                 GridOrigin.longitude + std::fmod(index * 0.61 * extent, extent));
+        }
+
+        /// Searches using spatial index of element store.
+        std::uint64_t searchIndexed(ElementStore& elementStore, const std::string& name)
+        {
+            ElementCounter counter;
+            std::size_t query = 0;
+            auto time = BenchmarkUtils::run(QueryCount, [&]() {
+                elementStore.search(getCenter(query++), Radius, counter);
+            });
+
+            BenchmarkUtils::report(name, QueryCount, time);
+            return counter.count;
+        }
+
+        /// Searches by reading all quadkeys which cover circle and checking distance.
+        std::uint64_t searchNaive(ElementStore& elementStore, const std::string& name)
+        {
+            DistanceCounter counter;
+            std::size_t query = 0;
+            auto time = BenchmarkUtils::run(QueryCount, [&]() {
+                counter.center = getCenter(query++);
+                double latOffset = GeoUtils::getOffset(counter.center, Radius);
+                double lonOffset = latOffset / std::cos(deg2Rad(counter.center.latitude));
+                BoundingBox bbox(GeoCoordinate(counter.center.latitude - latOffset, counter.center.longitude - lonOffset),
+                                 GeoCoordinate(counter.center.latitude + latOffset, counter.center.longitude + lonOffset));
+                GeoUtils::visitTileRange(bbox, LevelOfDetail, [&](const QuadKey& quadKey, const BoundingBox&) {
+                    elementStore.search(quadKey, counter);
+                });
+            });
+
+            BenchmarkUtils::report(name, QueryCount, time);
+            return counter.count;
+        }
+
+        DependencyProvider dependencyProvider;
+    };
+}
+
+BOOST_FIXTURE_TEST_SUITE(Index_RadiusSearch, Index_RadiusSearchBenchmarkFixture)
+
+BOOST_AUTO_TEST_CASE(GivenInMemoryStore_WhenSearchInRadius_ThenReportThroughput)
+{
+    InMemoryElementStore elementStore(*dependencyProvider.getStringTable());
+    store(elementStore);
+
+    auto naive = searchNaive(elementStore, "InMemoryElementStore radius search (quadkey scan)");
+    auto indexed = searchIndexed(elementStore, "InMemoryElementStore radius search (r-tree)");
+
+    BOOST_CHECK_GT(indexed, 0);
+    BOOST_CHECK_EQUAL(indexed, naive);
+}
+
+BOOST_AUTO_TEST_CASE(GivenPersistentStore_WhenSearchInRadius_ThenReportThroughput)
+{
+    PersistentElementStore elementStore("", *dependencyProvider.getStringTable());
+    store(elementStore);
+
+    auto naive = searchNaive(elementStore, "PersistentElementStore radius search (quadkey scan)");
+    auto indexed = searchIndexed(elementStore, "PersistentElementStore radius search (r-tree)");
+
+    BOOST_CHECK_GT(indexed, 0);
+    BOOST_CHECK_EQUAL(indexed, naive);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,73 @@
+#include "index/StringTable.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include "BenchmarkUtils.hpp"
+#include "test_utils/DependencyProvider.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace utymap::benchmarks;
+using namespace utymap::index;
+using namespace utymap::tests;
+
+namespace {
+    const std::size_t StringCount = 10000;
+    const std::size_t LookupCount = 1000000;
+
+    struct Index_StringTableBenchmarkFixture
+    {
+        Index_StringTableBenchmarkFixture() : strings()
+        {
+            for (std::size_t i = 0; i < StringCount; ++i)
+                strings.push_back("key" + std::to_string(i));
+        }
+
+        /// Runs lookups of existing strings from given amount of threads and reports total throughput.
+        void lookup(std::size_t threadCount)
+        {
+            auto& stringTable = *dependencyProvider.getStringTable();
+            for (const auto& str : strings)
+                stringTable.getId(str);
+
+            std::vector<std::size_t> sizes(threadCount, 0);
+            auto time = BenchmarkUtils::run(1, [&]() {
+                std::vector<std::thread> threads;
+                for (std::size_t t = 0; t < threadCount; ++t) {
+                    threads.push_back(std::thread([&, t]() {
+                        for (std::size_t i = 0; i < LookupCount; ++i) {
+                            const auto& str = strings[(i + t) % StringCount];
+                            sizes[t] += stringTable.getString(stringTable.getId(str)).size();
+                        }
+                    }));
+                }
+                for (auto& thread : threads)
+                    thread.join();
+            });
+
+            for (auto size : sizes)
+                BOOST_CHECK_GT(size, LookupCount);
+
+            BenchmarkUtils::report("StringTable getId/getString (" + std::to_string(threadCount) + " threads)",
+                                   threadCount * LookupCount, time);
+        }
+
+        DependencyProvider dependencyProvider;
+        std::vector<std::string> strings;
+    };
+}
+
+BOOST_FIXTURE_TEST_SUITE(Index_StringTable, Index_StringTableBenchmarkFixture)
+
+BOOST_AUTO_TEST_CASE(GivenExistingStrings_WhenLookupFromOneThread_ThenReportThroughput)
+{
+    lookup(1);
+}
+
+BOOST_AUTO_TEST_CASE(GivenExistingStrings_WhenLookupFromManyThreads_ThenReportThroughput)
+{
+    lookup(std::max<std::size_t>(std::thread::hardware_concurrency(), 2));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,2 @@
+#define BOOST_TEST_MODULE utymap_benchmark
+#include <boost/test/unit_test.hpp>
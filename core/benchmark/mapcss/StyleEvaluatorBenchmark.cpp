@@ -0,0 +1,77 @@
+#include "entities/Node.hpp"
+#include "mapcss/StyleDeclaration.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include "BenchmarkUtils.hpp"
+#include "test_utils/DependencyProvider.hpp"
+#include "test_utils/ElementUtils.hpp"
+
+using namespace utymap;
+using namespace utymap::benchmarks;
+using namespace utymap::entities;
+using namespace utymap::mapcss;
+using namespace utymap::tests;
+
+namespace {
+    const std::size_t Iterations = 200000;
+
+    /// Typical expressions used by building rules of default stylesheet.
+    const std::vector<std::string> Expressions = {
+        "eval(\"tag('building:levels') * 3.2\")",
+        "eval(\"tag('height') - tag('roof:height')\")",
+        "eval(\"tag('building:height') - tag('roof:height')\")",
+        "eval(\"tag('min_height')\")"
+    };
+
+    struct MapCss_StyleEvaluatorBenchmarkFixture
+    {
+        MapCss_StyleEvaluatorBenchmarkFixture() :
+            tags(ElementUtils::createElement<Node>(*dependencyProvider.getStringTable(), 0, {
+                { "building", "yes" },
+                { "building:height", "21" },
+                { "building:levels", "5" },
+                { "height", "20" },
+                { "min_height", "3" },
+                { "roof:height", "2.5" }
+            }).tags)
+        {
+        }
+
+        /// Evaluates all declarations and reports throughput.
+        double evaluate(const std::vector<std::unique_ptr<StyleDeclaration>>& declarations, const std::string& name)
+        {
+            auto& stringTable = *dependencyProvider.getStringTable();
+            double sum = 0;
+            auto time = BenchmarkUtils::run(Iterations, [&]() {
+                for (const auto& declaration : declarations)
+                    sum += declaration->evaluate<double>(tags, stringTable);
+            });
+
+            BenchmarkUtils::report(name, Iterations * declarations.size(), time);
+            return sum;
+        }
+
+        DependencyProvider dependencyProvider;
+        std::vector<Tag> tags;
+    };
+}
+
+BOOST_FIXTURE_TEST_SUITE(MapCss_StyleEvaluator, MapCss_StyleEvaluatorBenchmarkFixture)
+
+BOOST_AUTO_TEST_CASE(GivenTypicalExpressions_WhenEvaluate_ThenReportThroughput)
+{
+    std::vector<std::unique_ptr<StyleDeclaration>> uncompiled;
+    std::vector<std::unique_ptr<StyleDeclaration>> compiled;
+    for (const auto& expression : Expressions) {
+        uncompiled.push_back(utymap::utils::make_unique<StyleDeclaration>(0, expression));
+        compiled.push_back(utymap::utils::make_unique<StyleDeclaration>(0, expression, *dependencyProvider.getStringTable()));
+    }
+
+    double expected = evaluate(uncompiled, "StyleDeclaration evaluation (compile per call)");
+    double actual = evaluate(compiled, "StyleDeclaration evaluation (precompiled)");
+
+    BOOST_CHECK_GT(actual, 0);
+    BOOST_CHECK_EQUAL(actual, expected);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
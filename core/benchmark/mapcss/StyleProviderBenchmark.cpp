@@ -0,0 +1,82 @@
+#include "entities/Node.hpp"
+#include "entities/Way.hpp"
+#include "entities/Area.hpp"
+#include "entities/Relation.hpp"
+#include "formats/osm/OsmDataVisitor.hpp"
+#include "formats/osm/xml/OsmXmlParser.hpp"
+#include "mapcss/MapCssParser.hpp"
+#include "mapcss/StyleProvider.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include "BenchmarkUtils.hpp"
+#include "config.hpp"
+#include "test_utils/DependencyProvider.hpp"
+
+#include <fstream>
+
+using namespace utymap;
+using namespace utymap::benchmarks;
+using namespace utymap::entities;
+using namespace utymap::formats;
+using namespace utymap::mapcss;
+using namespace utymap::tests;
+
+namespace {
+    const int LevelOfDetail = 16;
+    const std::size_t Iterations = 20;
+
+    /// Keeps copies of visited elements.
+    struct ElementCollector : public ElementVisitor
+    {
+        std::vector<std::shared_ptr<Element>> elements;
+
+        void visitNode(const Node& node) override { elements.push_back(std::make_shared<Node>(node)); }
+        void visitWay(const Way& way) override { elements.push_back(std::make_shared<Way>(way)); }
+        void visitArea(const Area& area) override { elements.push_back(std::make_shared<Area>(area)); }
+        void visitRelation(const Relation& relation) override { elements.push_back(std::make_shared<Relation>(relation)); }
+    };
+
+    struct MapCss_StyleProviderBenchmarkFixture
+    {
+        MapCss_StyleProviderBenchmarkFixture()
+        {
+            std::ifstream styleFile(TEST_MAPCSS_DEFAULT);
+            std::string stylePath = TEST_MAPCSS_DEFAULT;
+            MapCssParser parser(stylePath.substr(0, stylePath.find_last_of("\\/") + 1));
+            stylesheet = parser.parse(styleFile);
+
+            std::ifstream xmlFile(TEST_XML_FILE);
+            OsmXmlParser<OsmDataVisitor> xmlParser;
+            OsmDataVisitor visitor(*dependencyProvider.getStringTable(), [&](Element& element) {
+                element.accept(collector);
+                return true;
+            });
+            xmlParser.parse(xmlFile, visitor);
+            visitor.complete();
+        }
+
+        DependencyProvider dependencyProvider;
+        StyleSheet stylesheet;
+        ElementCollector collector;
+    };
+}
+
+BOOST_FIXTURE_TEST_SUITE(MapCss_StyleProvider, MapCss_StyleProviderBenchmarkFixture)
+
+BOOST_AUTO_TEST_CASE(GivenDefaultStylesheet_WhenResolveStylesWithoutCache_ThenReportThroughput)
+{
+    StyleProvider styleProvider(stylesheet, *dependencyProvider.getStringTable(), 0);
+    std::size_t declarations = 0;
+
+    auto time = BenchmarkUtils::run(Iterations, [&]() {
+        for (const auto& element : collector.elements) {
+            if (styleProvider.hasStyle(*element, LevelOfDetail))
+                declarations += styleProvider.forElement(*element, LevelOfDetail).declarations().size();
+        }
+    });
+
+    BenchmarkUtils::report("StyleProvider style resolution", Iterations * collector.elements.size(), time);
+    BOOST_CHECK_GT(declarations, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
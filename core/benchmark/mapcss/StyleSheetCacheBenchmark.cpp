@@ -0,0 +1,56 @@
+#include "mapcss/MapCssParser.hpp"
+#include "mapcss/StyleSheetCache.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include "BenchmarkUtils.hpp"
+#include "config.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace utymap::benchmarks;
+using namespace utymap::mapcss;
+
+namespace {
+    const std::size_t Iterations = 10;
+
+    struct MapCss_StyleSheetCacheBenchmarkFixture
+    {
+        MapCss_StyleSheetCacheBenchmarkFixture() : cache("")
+        {
+        }
+
+        ~MapCss_StyleSheetCacheBenchmarkFixture()
+        {
+            std::remove(cache.getCachePath(TEST_MAPCSS_DEFAULT).c_str());
+        }
+
+        StyleSheetCache cache;
+    };
+}
+
+BOOST_FIXTURE_TEST_SUITE(MapCss_StyleSheetCache, MapCss_StyleSheetCacheBenchmarkFixture)
+
+BOOST_AUTO_TEST_CASE(GivenDefaultStylesheet_WhenLoad_ThenReportTime)
+{
+    std::string stylePath = TEST_MAPCSS_DEFAULT;
+    MapCssParser parser(stylePath.substr(0, stylePath.find_last_of("\\/") + 1));
+    std::size_t parsedRules = 0, cachedRules = 0;
+
+    auto parseTime = BenchmarkUtils::run(Iterations, [&]() {
+        std::ifstream styleFile(stylePath);
+        parsedRules = parser.parse(styleFile).rules.size();
+    });
+    BenchmarkUtils::report("MapCssParser parse", Iterations, parseTime);
+
+    cache.get(stylePath);
+    auto cacheTime = BenchmarkUtils::run(Iterations, [&]() {
+        cachedRules = cache.get(stylePath).rules.size();
+    });
+    BenchmarkUtils::report("StyleSheetCache load", Iterations, cacheTime);
+
+    BOOST_CHECK_GT(cachedRules, 0);
+    BOOST_CHECK_EQUAL(cachedRules, parsedRules);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
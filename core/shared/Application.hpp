@@ -4,6 +4,7 @@
 #include "BoundingBox.hpp"
 #include "QuadKey.hpp"
 #include "LodRange.hpp"
+#include "builders/BuildQueue.hpp"
 #include "builders/BuilderContext.hpp"
 #include "builders/QuadKeyBuilder.hpp"
 #include "builders/buildings/BuildingBuilder.hpp"
@@ -18,16 +19,21 @@
 #include "index/GeoStore.hpp"
 #include "index/InMemoryElementStore.hpp"
 #include "index/PersistentElementStore.hpp"
-#include "mapcss/MapCssParser.hpp"
 #include "mapcss/StyleSheet.hpp"
+#include "mapcss/StyleSheetCache.hpp"
 #include "utils/CoreUtils.hpp"
+#include "utils/ThreadPool.hpp"
 
 #include "Callbacks.hpp"
 #include "ExportElementVisitor.hpp"
 
+#include <algorithm>
 #include <exception>
 #include <fstream>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 /// Exposes API for external usage.
@@ -42,11 +48,14 @@ public:
     };
 
     /// Composes object graph.
+    /// NOTE decoded elements of recently built tiles are cached to speed up panning.
     Application(const char* dataPath, 
                 OnError* errorCallback) :
-        stringTable_(dataPath), geoStore_(stringTable_),
+        stringTable_(dataPath), geoStore_(stringTable_, 0, 64 * 1024 * 1024),
         flatEleProvider_(), srtmEleProvider_(dataPath), gridEleProvider_(dataPath),
-        quadKeyBuilder_(geoStore_, stringTable_)
+        quadKeyBuilder_(geoStore_, stringTable_), styleSheetCache_(dataPath), styleProviders_(), styleLock_(), callbackLock_(),
+        buildPool_(std::max(1u, std::thread::hardware_concurrency())),
+        buildQueue_(std::max(1u, std::thread::hardware_concurrency()))
     {
         registerDefaultBuilders();
     }
@@ -132,26 +141,137 @@ public:
                      OnError* errorCallback)
     {
         safeExecute([&]() {
-            auto& styleProvider = getStyleProvider(styleFile);
-            auto& eleProvider = getElevationProvider(quadKey, eleDataType);
-            ExportElementVisitor elementVisitor(quadKey, stringTable_, styleProvider, eleProvider, elementCallback);
-            quadKeyBuilder_.build(quadKey, styleProvider, eleProvider,
-                [&meshCallback](const utymap::math::Mesh& mesh) {
-                // NOTE do not notify if mesh is empty.
-                if (!mesh.vertices.empty()) {
-                    meshCallback(mesh.name.data(),
-                        mesh.vertices.data(), static_cast<int>(mesh.vertices.size()),
-                        mesh.triangles.data(), static_cast<int>(mesh.triangles.size()),
-                        mesh.colors.data(), static_cast<int>(mesh.colors.size()),
-                        mesh.uvs.data(), static_cast<int>(mesh.uvs.size()),
-                        mesh.uvMap.data(), static_cast<int>(mesh.uvMap.size()));
-                }
-            }, [&elementVisitor](const utymap::entities::Element& element) {
-                element.accept(elementVisitor);
-            });
+            buildQuadKey(getStyleProvider(styleFile), quadKey, eleDataType, meshCallback, elementCallback);
         }, errorCallback);
     }
 
+    /// Loads given quadkeys concurrently using worker pool. Blocks till all of them are built.
+    /// NOTE callbacks are serialized, so external code does not need to be thread safe. Index
+    /// passed to callback is index of quadkey in given vector. Error of one tile does not stop others.
+    void loadQuadKeys(const char* styleFile,
+                      const std::vector<utymap::QuadKey>& quadKeys,
+                      const ElevationDataType& eleDataType,
+                      OnTileMeshBuilt* meshCallback,
+                      OnTileElementLoaded* elementCallback,
+                      OnTileError* errorCallback)
+    {
+        std::mutex callbackLock;
+        const utymap::mapcss::StyleProvider* styleProvider = nullptr;
+        try {
+            styleProvider = &getStyleProvider(styleFile);
+        }
+        catch (std::exception& ex) {
+            for (std::size_t i = 0; i < quadKeys.size(); ++i)
+                errorCallback(static_cast<int>(i), ex.what());
+            return;
+        }
+
+        std::vector<std::future<void>> results;
+        results.reserve(quadKeys.size());
+        for (std::size_t i = 0; i < quadKeys.size(); ++i) {
+            int tileIndex = static_cast<int>(i);
+            results.push_back(buildPool_.enqueue([&, tileIndex]() {
+                try {
+                    buildQuadKey(*styleProvider, quadKeys[tileIndex], eleDataType,
+                        [&, tileIndex](const char* name,
+                                       const double* vertices, int vertexSize,
+                                       const int* triangles, int triSize,
+                                       const int* colors, int colorSize,
+                                       const double* uvs, int uvSize,
+                                       const int* uvMap, int uvMapSize) {
+                        std::lock_guard<std::mutex> lock(callbackLock);
+                        meshCallback(tileIndex, name, vertices, vertexSize, triangles, triSize,
+                                     colors, colorSize, uvs, uvSize, uvMap, uvMapSize);
+                    }, [&, tileIndex](std::uint64_t id,
+                                      const char** tags, int tagsSize,
+                                      const double* vertices, int vertexSize,
+                                      const char** style, int styleSize) {
+                        std::lock_guard<std::mutex> lock(callbackLock);
+                        elementCallback(tileIndex, id, tags, tagsSize, vertices, vertexSize, style, styleSize);
+                    });
+                }
+                catch (std::exception& ex) {
+                    std::lock_guard<std::mutex> lock(callbackLock);
+                    errorCallback(tileIndex, ex.what());
+                }
+            }));
+        }
+
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            try {
+                results[i].get();
+            }
+            catch (std::exception& ex) {
+                std::lock_guard<std::mutex> lock(callbackLock);
+                errorCallback(static_cast<int>(i), ex.what());
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(callbackLock);
+                errorCallback(static_cast<int>(i), "Unknown error.");
+            }
+        }
+    }
+
+    /// Schedules build of given quadkey on worker thread. Tiles with lower priority value
+    /// (e.g. distance to camera) are built first. If quadkey is already scheduled, its build
+    /// is replaced with this one. Returns false if quadkey is being built, so nothing is scheduled.
+    /// NOTE callbacks are serialized. Cancelled tile is not completed, but some of its meshes
+    /// and elements might be already reported.
+    bool scheduleQuadKey(const char* styleFile,
+                         const utymap::QuadKey& quadKey,
+                         const ElevationDataType& eleDataType,
+                         double priority,
+                         OnMeshBuilt* meshCallback,
+                         OnElementLoaded* elementCallback,
+                         OnTileBuilt* completionCallback,
+                         OnError* errorCallback)
+    {
+        std::string stylePath = styleFile;
+        return buildQueue_.enqueue(quadKey, priority, [=](const utymap::QuadKey& quadKey,
+                                                   const utymap::utils::CancellationToken& cancelToken) {
+            try {
+                buildQuadKey(getStyleProvider(stylePath), quadKey, eleDataType,
+                    [&](const char* name,
+                        const double* vertices, int vertexSize,
+                        const int* triangles, int triSize,
+                        const int* colors, int colorSize,
+                        const double* uvs, int uvSize,
+                        const int* uvMap, int uvMapSize) {
+                    std::lock_guard<std::mutex> lock(callbackLock_);
+                    meshCallback(name, vertices, vertexSize, triangles, triSize,
+                                 colors, colorSize, uvs, uvSize, uvMap, uvMapSize);
+                }, [&](std::uint64_t id,
+                       const char** tags, int tagsSize,
+                       const double* vertices, int vertexSize,
+                       const char** style, int styleSize) {
+                    std::lock_guard<std::mutex> lock(callbackLock_);
+                    elementCallback(id, tags, tagsSize, vertices, vertexSize, style, styleSize);
+                }, cancelToken);
+
+                if (!cancelToken.isCancelled()) {
+                    std::lock_guard<std::mutex> lock(callbackLock_);
+                    completionCallback();
+                }
+            }
+            catch (std::exception& ex) {
+                std::lock_guard<std::mutex> lock(callbackLock_);
+                errorCallback(ex.what());
+            }
+        });
+    }
+
+    /// Cancels pending or running build of given quadkey.
+    bool cancelQuadKey(const utymap::QuadKey& quadKey)
+    {
+        return buildQueue_.cancel(quadKey);
+    }
+
+    /// Cancels all scheduled builds.
+    void cancelQuadKeys()
+    {
+        buildQueue_.cancelAll();
+    }
+
     /// Gets id for the string.
     std::uint32_t getStringId(const char* str) const
     {
@@ -178,6 +298,32 @@ private:
         }
     }
 
+    /// Builds quadkey on calling thread. It is safe to call it from multiple threads.
+    void buildQuadKey(const utymap::mapcss::StyleProvider& styleProvider,
+                      const utymap::QuadKey& quadKey,
+                      const ElevationDataType& eleDataType,
+                      const std::function<OnMeshBuilt>& meshCallback,
+                      const std::function<OnElementLoaded>& elementCallback,
+                      const utymap::utils::CancellationToken& cancelToken = utymap::utils::CancellationToken())
+    {
+        auto& eleProvider = getElevationProvider(quadKey, eleDataType);
+        ExportElementVisitor elementVisitor(quadKey, stringTable_, styleProvider, eleProvider, elementCallback);
+        quadKeyBuilder_.build(quadKey, styleProvider, eleProvider,
+            [&meshCallback](const utymap::math::Mesh& mesh) {
+            // NOTE do not notify if mesh is empty.
+            if (!mesh.vertices.empty()) {
+                meshCallback(mesh.name.data(),
+                    mesh.vertices.data(), static_cast<int>(mesh.vertices.size()),
+                    mesh.triangles.data(), static_cast<int>(mesh.triangles.size()),
+                    mesh.colors.data(), static_cast<int>(mesh.colors.size()),
+                    mesh.uvs.data(), static_cast<int>(mesh.uvs.size()),
+                    mesh.uvMap.data(), static_cast<int>(mesh.uvMap.size()));
+            }
+        }, [&elementVisitor](const utymap::entities::Element& element) {
+            element.accept(elementVisitor);
+        }, cancelToken);
+    }
+
     const utymap::heightmap::ElevationProvider& getElevationProvider(const utymap::QuadKey& quadKey,
                                                                      const ElevationDataType& eleDataType) const
     {
@@ -193,19 +339,14 @@ private:
 
     const utymap::mapcss::StyleProvider& getStyleProvider(const std::string& stylePath)
     {
+        std::lock_guard<std::mutex> lock(styleLock_);
         auto pair = styleProviders_.find(stylePath);
         if (pair != styleProviders_.end())
             return *pair->second;
 
-        std::ifstream styleFile(stylePath);
-        if (!styleFile.good())
-            throw std::invalid_argument(std::string("Cannot read mapcss file:") + stylePath);
+        // NOTE parsing is skipped when binary cache is up to date.
+        utymap::mapcss::StyleSheet stylesheet = styleSheetCache_.get(stylePath);
 
-        // NOTE not safe, but don't want to use boost filesystem only for this task.
-        std::string dir = stylePath.substr(0, stylePath.find_last_of("\\/") + 1);
-        utymap::mapcss::MapCssParser parser(dir);
-        utymap::mapcss::StyleSheet stylesheet = parser.parse(styleFile);
-      
         styleProviders_.emplace(
             stylePath, 
             utymap::utils::make_unique<const utymap::mapcss::StyleProvider>(stylesheet, stringTable_));
@@ -248,7 +389,14 @@ private:
     utymap::heightmap::GridElevationProvider gridEleProvider_;
 
     utymap::builders::QuadKeyBuilder quadKeyBuilder_;
+    utymap::mapcss::StyleSheetCache styleSheetCache_;
     std::unordered_map<std::string, std::unique_ptr<const utymap::mapcss::StyleProvider>> styleProviders_;
+    std::mutex styleLock_;
+    std::mutex callbackLock_;
+
+    /// NOTE should be the last members: workers are stopped before other members are destroyed.
+    utymap::utils::ThreadPool buildPool_;
+    utymap::builders::BuildQueue buildQueue_;
 };
 
 #endif // APPLICATION_HPP_DEFINED
@@ -20,4 +20,26 @@ typedef void OnElementLoaded(std::uint64_t id,                       // element
 /// Callback which is called when operation is completed.
 typedef void OnError(const char* errorMessage);
 
+/// Callback which is called when scheduled tile is built.
+typedef void OnTileBuilt();
+
+/// Callback which is called when mesh of tile with given index is built by batch load.
+typedef void OnTileMeshBuilt(int tileIndex,                          // index of tile in request
+                             const char* name,                       // name
+                             const double* vertices, int vertexSize, // vertices (x, y, elevation)
+                             const int* triangles, int triSize,      // triangle indices
+                             const int* colors, int colorSize,       // rgba colors
+                             const double* uvs, int uvSize,          // absolute texture uvs
+                             const int* uvMap, int uvMapSize);       // map with info about used atlas and texture region
+
+/// Callback which is called when element of tile with given index is loaded by batch load.
+typedef void OnTileElementLoaded(int tileIndex,                          // index of tile in request
+                                 std::uint64_t id,                       // element id
+                                 const char** tags, int tagsSize,        // tags
+                                 const double* vertices, int vertexSize, // vertices (x, y, elevation)
+                                 const char** style, int styleSize);     // mapcss styles (key, value)
+
+/// Callback which is called when tile with given index cannot be built by batch load.
+typedef void OnTileError(int tileIndex, const char* errorMessage);
+
 #endif // CALLBACKS_HPP_DEFINED
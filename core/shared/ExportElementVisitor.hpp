@@ -11,6 +11,7 @@
 #include "heightmap/ElevationProvider.hpp"
 #include "mapcss/StyleProvider.hpp"
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -19,12 +20,13 @@ struct ExportElementVisitor : public utymap::entities::ElementVisitor
 {
     using Tags = std::vector<utymap::formats::Tag>;
     using Coordinates = std::vector<utymap::GeoCoordinate>;
+    using ElementCallback = std::function<OnElementLoaded>;
 
     ExportElementVisitor(const utymap::QuadKey& quadKey,
                          utymap::index::StringTable& stringTable,
                          const utymap::mapcss::StyleProvider& styleProvider,
                          const utymap::heightmap::ElevationProvider& eleProvider,
-                         OnElementLoaded* elementCallback) :
+                         ElementCallback elementCallback) :
         quadKey_(quadKey), stringTable_(stringTable), styleProvider_(styleProvider), 
         eleProvider_(eleProvider), elementCallback_(elementCallback)
     {
@@ -100,7 +102,7 @@ private:
     utymap::index::StringTable& stringTable_;
     const utymap::mapcss::StyleProvider& styleProvider_;
     const utymap::heightmap::ElevationProvider& eleProvider_;
-    OnElementLoaded* elementCallback_;
+    ElementCallback elementCallback_;
     std::vector<std::string> tagStrings_;   // holds temporary tag strings
     std::vector<std::string> styleStrings_; // holds temporary style strings
 };
@@ -149,6 +149,52 @@ extern "C"
             meshCallback, elementCallback, errorCallback);
     }
 
+    /// Loads multiple quadkeys concurrently. Blocks till all of them are built.
+    void EXPORT_API loadQuadKeys(const char* styleFile,                    // style file
+                                 const int* quadKeys,                      // quadkeys as (x, y, lod) triplets
+                                 int quadKeyCount,                         // amount of quadkeys
+                                 int eleDataType,                          // elevation data type
+                                 OnTileMeshBuilt* meshCallback,            // mesh callback
+                                 OnTileElementLoaded* elementCallback,     // element callback
+                                 OnTileError* errorCallback)               // error callback
+    {
+        std::vector<utymap::QuadKey> keys;
+        keys.reserve(static_cast<std::size_t>(quadKeyCount));
+        for (int i = 0; i < quadKeyCount; ++i)
+            keys.push_back(utymap::QuadKey(quadKeys[i * 3 + 2], quadKeys[i * 3], quadKeys[i * 3 + 1]));
+
+        applicationPtr->loadQuadKeys(styleFile, keys, static_cast<Application::ElevationDataType>(eleDataType),
+            meshCallback, elementCallback, errorCallback);
+    }
+
+    /// Schedules quadkey build on worker thread. Tiles with lower priority are built first.
+    /// Returns false if quadkey is being built already.
+    bool EXPORT_API scheduleQuadKey(const char* styleFile,                   // style file
+                                    int tileX, int tileY, int levelOfDetail, // quadkey info
+                                    int eleDataType,                         // elevation data type
+                                    double priority,                         // priority, e.g. distance to camera
+                                    OnMeshBuilt* meshCallback,               // mesh callback
+                                    OnElementLoaded* elementCallback,        // element callback
+                                    OnTileBuilt* completionCallback,         // completion callback
+                                    OnError* errorCallback)                  // error callback
+    {
+        utymap::QuadKey quadKey(levelOfDetail, tileX, tileY);
+        return applicationPtr->scheduleQuadKey(styleFile, quadKey, static_cast<Application::ElevationDataType>(eleDataType),
+            priority, meshCallback, elementCallback, completionCallback, errorCallback);
+    }
+
+    /// Cancels scheduled quadkey build.
+    bool EXPORT_API cancelQuadKey(int tileX, int tileY, int levelOfDetail)
+    {
+        return applicationPtr->cancelQuadKey(utymap::QuadKey(levelOfDetail, tileX, tileY));
+    }
+
+    /// Cancels all scheduled quadkey builds.
+    void EXPORT_API cancelQuadKeys()
+    {
+        applicationPtr->cancelQuadKeys();
+    }
+
     /// Checks whether there is data for given quadkey.
     bool EXPORT_API hasData(int tileX, int tileY, int levelOfDetail)
     {
@@ -0,0 +1,209 @@
+#include "builders/BuildQueue.hpp"
+#include "utils/CoreUtils.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace utymap;
+using namespace utymap::builders;
+using namespace utymap::utils;
+
+namespace {
+    /// Defines order of pending builds: by priority and then by arrival.
+    typedef std::pair<double, std::uint64_t> BuildOrder;
+
+    /// Represents build which is waiting for worker.
+    struct PendingBuild final
+    {
+        BuildOrder order;
+        BuildQueue::BuildTask task;
+    };
+}
+
+class BuildQueue::BuildQueueImpl final
+{
+    typedef std::map<QuadKey, PendingBuild, QuadKey::Comparator> PendingMap;
+    typedef std::map<BuildOrder, QuadKey> OrderMap;
+    /// NOTE cancelled build might be still running when the same quadkey is started again.
+    typedef std::multimap<QuadKey, std::shared_ptr<CancellationToken>, QuadKey::Comparator> RunningMap;
+
+public:
+    explicit BuildQueueImpl(std::size_t threadCount) :
+        pending_(), order_(), running_(), sequence_(0), stop_(false)
+    {
+        for (std::size_t i = 0; i < threadCount; ++i)
+            workers_.emplace_back([this]() { run(); });
+    }
+
+    ~BuildQueueImpl()
+    {
+        {
+            std::unique_lock<std::mutex> lock(lock_);
+            stop_ = true;
+            clear();
+        }
+        condition_.notify_all();
+        for (auto& worker : workers_)
+            worker.join();
+    }
+
+    bool enqueue(const QuadKey& quadKey, double priority, BuildTask task)
+    {
+        {
+            std::unique_lock<std::mutex> lock(lock_);
+            if (stop_)
+                return false;
+
+            // NOTE replaced task keeps its place among pending builds with equal priority.
+            auto pending = pending_.find(quadKey);
+            if (pending != pending_.end()) {
+                order_.erase(pending->second.order);
+                pending->second.order.first = priority;
+                pending->second.task = std::move(task);
+                order_.emplace(pending->second.order, quadKey);
+                return true;
+            }
+
+            auto range = running_.equal_range(quadKey);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (!it->second->isCancelled())
+                    return false;
+            }
+
+            BuildOrder order(priority, sequence_++);
+            pending_.emplace(quadKey, PendingBuild{ order, std::move(task) });
+            order_.emplace(order, quadKey);
+        }
+        condition_.notify_one();
+        return true;
+    }
+
+    bool cancel(const QuadKey& quadKey)
+    {
+        std::unique_lock<std::mutex> lock(lock_);
+        bool isFound = false;
+
+        auto pending = pending_.find(quadKey);
+        if (pending != pending_.end()) {
+            order_.erase(pending->second.order);
+            pending_.erase(pending);
+            isFound = true;
+        }
+
+        auto range = running_.equal_range(quadKey);
+        for (auto it = range.first; it != range.second; ++it) {
+            it->second->cancel();
+            isFound = true;
+        }
+
+        notifyIfIdle();
+        return isFound;
+    }
+
+    void cancelAll()
+    {
+        std::unique_lock<std::mutex> lock(lock_);
+        clear();
+        notifyIfIdle();
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(lock_);
+        idle_.wait(lock, [this]() { return pending_.empty() && running_.empty(); });
+    }
+
+private:
+    void run()
+    {
+        while (true) {
+            QuadKey quadKey;
+            BuildTask task;
+            RunningMap::iterator running;
+            {
+                std::unique_lock<std::mutex> lock(lock_);
+                condition_.wait(lock, [this]() { return stop_ || !order_.empty(); });
+                if (stop_)
+                    return;
+
+                quadKey = order_.begin()->second;
+                order_.erase(order_.begin());
+                auto pending = pending_.find(quadKey);
+                task = std::move(pending->second.task);
+                pending_.erase(pending);
+                running = running_.emplace(quadKey, std::make_shared<CancellationToken>());
+            }
+
+            // NOTE task is expected to handle own errors.
+            try {
+                task(quadKey, *running->second);
+            }
+            catch (...) {
+            }
+
+            std::unique_lock<std::mutex> lock(lock_);
+            running_.erase(running);
+            notifyIfIdle();
+        }
+    }
+
+    /// Drops pending builds and cancels running ones. Should be called under lock.
+    void clear()
+    {
+        pending_.clear();
+        order_.clear();
+        for (auto& running : running_)
+            running.second->cancel();
+    }
+
+    /// Wakes up waiting threads if there is no work left. Should be called under lock.
+    void notifyIfIdle()
+    {
+        if (pending_.empty() && running_.empty())
+            idle_.notify_all();
+    }
+
+    PendingMap pending_;
+    OrderMap order_;
+    RunningMap running_;
+    std::uint64_t sequence_;
+    bool stop_;
+
+    std::vector<std::thread> workers_;
+    std::mutex lock_;
+    std::condition_variable condition_;
+    std::condition_variable idle_;
+};
+
+BuildQueue::BuildQueue(std::size_t threadCount) :
+    pimpl_(utymap::utils::make_unique<BuildQueueImpl>(threadCount))
+{
+}
+
+BuildQueue::~BuildQueue()
+{
+}
+
+bool BuildQueue::enqueue(const QuadKey& quadKey, double priority, BuildTask task)
+{
+    return pimpl_->enqueue(quadKey, priority, std::move(task));
+}
+
+bool BuildQueue::cancel(const QuadKey& quadKey)
+{
+    return pimpl_->cancel(quadKey);
+}
+
+void BuildQueue::cancelAll()
+{
+    pimpl_->cancelAll();
+}
+
+void BuildQueue::wait()
+{
+    pimpl_->wait();
+}
@@ -0,0 +1,46 @@
+#ifndef BUILDERS_BUILDQUEUE_HPP_DEFINED
+#define BUILDERS_BUILDQUEUE_HPP_DEFINED
+
+#include "QuadKey.hpp"
+#include "utils/CancellationToken.hpp"
+
+#include <functional>
+#include <memory>
+
+namespace utymap { namespace builders {
+
+/// Schedules tile builds on worker threads. Pending tiles are built in priority order
+/// (lower value first), pending build of the same quadkey is replaced and builds can be cancelled.
+class BuildQueue final
+{
+public:
+    /// Builds tile for given quadkey. Should check token between expensive steps.
+    typedef std::function<void(const utymap::QuadKey&, const utymap::utils::CancellationToken&)> BuildTask;
+
+    explicit BuildQueue(std::size_t threadCount);
+
+    /// Cancels all builds and waits for running ones.
+    ~BuildQueue();
+
+    /// Schedules build of quadkey with given priority. If quadkey is already pending, its task
+    /// and priority are replaced with given ones. If quadkey is being built, task is dropped.
+    /// Returns true if task is scheduled.
+    bool enqueue(const utymap::QuadKey& quadKey, double priority, BuildTask task);
+
+    /// Cancels pending or running build of given quadkey. Returns false if there is none.
+    bool cancel(const utymap::QuadKey& quadKey);
+
+    /// Cancels all pending and running builds.
+    void cancelAll();
+
+    /// Waits till all scheduled builds are completed.
+    void wait();
+
+private:
+    class BuildQueueImpl;
+    std::unique_ptr<BuildQueueImpl> pimpl_;
+};
+
+}}
+
+#endif // BUILDERS_BUILDQUEUE_HPP_DEFINED
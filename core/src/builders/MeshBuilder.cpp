@@ -3,6 +3,7 @@
 
 #include "BoundingBox.hpp"
 #include "MeshBuilder.hpp"
+#include "clipper/clipper.hpp"
 #include "triangle/triangle.h"
 #include "utils/CoreUtils.hpp"
 #include "utils/GeoUtils.hpp"
@@ -13,6 +14,188 @@ using namespace utymap::heightmap;
 using namespace utymap::math;
 using namespace utymap::utils;
 
+namespace {
+    /// Scale used to convert coordinates to clipper's integer ones.
+    const double Scale = 1E7;
+    /// Tolerance used to find grid cells touched by polygon edges (in cell units).
+    const double CellTolerance = 1E-6;
+    /// Max amount of grid cells. Triangulation is used for larger grids.
+    const std::size_t MaxGridCells = 1 << 20;
+
+    /// Scratch buffers reused by meshing operations to avoid allocations per polygon.
+    /// NOTE mesh builder is created per tile build, so buffers are never shared between threads.
+    struct MeshingArena final
+    {
+        std::vector<double> triangleAreas;
+        std::vector<double> latitudes;
+        std::vector<double> longitudes;
+        std::vector<double> elevations;
+        std::vector<double> points;
+        std::vector<int> nodes;
+        std::vector<int> nodeIndices;
+        std::vector<int> triangles;
+    };
+
+    /// Maps geo coordinates to texture ones relative to bounding box.
+    struct TextureMapper final
+    {
+        double geoX, geoY, geoWidth, geoHeight, scale;
+        bool isEmpty;
+
+        utymap::math::Vector2 operator()(double x, double y) const
+        {
+            if (isEmpty)
+                return utymap::math::Vector2(0, 0);
+
+            return utymap::math::Vector2((x - geoX) / geoWidth * scale, (y - geoY) / geoHeight * scale);
+        }
+    };
+
+    /// Type of grid cell relative to polygon.
+    enum class CellType : std::uint8_t { Outside, Inside, Boundary };
+
+    /// Describes regular grid in clipper's coordinates.
+    struct Grid final
+    {
+        ClipperLib::cInt x, y, step;
+        int columns, rows;
+        std::vector<CellType> cells;
+
+        CellType& cell(int column, int row) { return cells[row * columns + column]; }
+        CellType cell(int column, int row) const { return cells[row * columns + column]; }
+
+        double u(const ClipperLib::IntPoint& p) const { return static_cast<double>(p.X - x) / step; }
+        double v(const ClipperLib::IntPoint& p) const { return static_cast<double>(p.Y - y) / step; }
+
+        /// Returns true if all cells around given node are inside polygon.
+        bool isInnerNode(int column, int row) const
+        {
+            for (int r = row - 1; r <= row; ++r)
+                for (int c = column - 1; c <= column; ++c)
+                    if (c < 0 || r < 0 || c >= columns || r >= rows || cells[r * columns + c] != CellType::Inside)
+                        return false;
+            return true;
+        }
+    };
+
+    ClipperLib::cInt floorDiv(ClipperLib::cInt value, ClipperLib::cInt divisor)
+    {
+        auto result = value / divisor;
+        return (value % divisor != 0 && value < 0) ? result - 1 : result;
+    }
+
+    ClipperLib::Path createRect(ClipperLib::cInt xMin, ClipperLib::cInt yMin, ClipperLib::cInt xMax, ClipperLib::cInt yMax)
+    {
+        return ClipperLib::Path {
+            ClipperLib::IntPoint(xMin, yMin), ClipperLib::IntPoint(xMax, yMin),
+            ClipperLib::IntPoint(xMax, yMax), ClipperLib::IntPoint(xMin, yMax)
+        };
+    }
+
+    /// Converts polygon contours into clipper paths.
+    ClipperLib::Paths toPaths(const Polygon& polygon)
+    {
+        ClipperLib::Paths paths;
+        auto add = [&](const Polygon::Range& range) {
+            ClipperLib::Path path;
+            path.reserve((range.second - range.first) / 2);
+            for (auto i = range.first; i < range.second; i += 2)
+                path.push_back(ClipperLib::IntPoint(static_cast<ClipperLib::cInt>(std::round(polygon.points[i] * Scale)),
+                                                    static_cast<ClipperLib::cInt>(std::round(polygon.points[i + 1] * Scale))));
+            paths.push_back(std::move(path));
+        };
+
+        std::for_each(polygon.outers.begin(), polygon.outers.end(), add);
+        std::for_each(polygon.inners.begin(), polygon.inners.end(), add);
+        return paths;
+    }
+
+    /// Adds clipper paths to polygon.
+    void addPaths(const ClipperLib::Paths& paths, Polygon& polygon)
+    {
+        for (const auto& path : paths) {
+            if (path.size() < 3 || ClipperLib::Area(path) == 0)
+                continue;
+
+            std::vector<Vector2> contour;
+            contour.reserve(path.size());
+            for (const auto& p : path)
+                contour.push_back(Vector2(p.X / Scale, p.Y / Scale));
+
+            if (ClipperLib::Orientation(path))
+                polygon.addContour(contour);
+            else
+                polygon.addHole(contour);
+        }
+    }
+
+    /// Marks cells touched by polygon edges as boundary ones.
+    void markBoundaryCells(const ClipperLib::Paths& paths, Grid& grid)
+    {
+        for (const auto& path : paths) {
+            for (std::size_t i = 0; i < path.size(); ++i) {
+                const auto& a = path[i];
+                const auto& b = path[(i + 1) % path.size()];
+                // NOTE edges on grid lines (e.g. tile borders) do not cross cells.
+                if ((a.X == b.X && (a.X - grid.x) % grid.step == 0) ||
+                    (a.Y == b.Y && (a.Y - grid.y) % grid.step == 0))
+                    continue;
+
+                double ua = grid.u(a), va = grid.v(a), ub = grid.u(b), vb = grid.v(b);
+                double vMin = std::min(va, vb), vMax = std::max(va, vb);
+
+                int rowStart = std::max(0, static_cast<int>(std::floor(vMin - CellTolerance)));
+                int rowEnd = std::min(grid.rows - 1, static_cast<int>(std::floor(vMax + CellTolerance)));
+                for (int row = rowStart; row <= rowEnd; ++row) {
+                    // part of edge inside row
+                    double lo = std::max(vMin, row - CellTolerance);
+                    double hi = std::min(vMax, row + 1 + CellTolerance);
+                    double uLo = va == vb ? std::min(ua, ub) : ua + (lo - va) * (ub - ua) / (vb - va);
+                    double uHi = va == vb ? std::max(ua, ub) : ua + (hi - va) * (ub - ua) / (vb - va);
+
+                    int columnStart = std::max(0, static_cast<int>(std::floor(std::min(uLo, uHi) - CellTolerance)));
+                    int columnEnd = std::min(grid.columns - 1, static_cast<int>(std::floor(std::max(uLo, uHi) + CellTolerance)));
+                    for (int column = columnStart; column <= columnEnd; ++column)
+                        grid.cell(column, row) = CellType::Boundary;
+                }
+            }
+        }
+    }
+
+    /// Marks cells which are not crossed by polygon edges and have center inside polygon.
+    void markInsideCells(const ClipperLib::Paths& paths, Grid& grid)
+    {
+        std::vector<double> crossings;
+        for (int row = 0; row < grid.rows; ++row) {
+            double v = row + 0.5;
+            crossings.clear();
+            for (const auto& path : paths) {
+                for (std::size_t i = 0; i < path.size(); ++i) {
+                    const auto& a = path[i];
+                    const auto& b = path[(i + 1) % path.size()];
+                    double va = grid.v(a), vb = grid.v(b);
+                    if ((va <= v) != (vb <= v)) {
+                        double ua = grid.u(a), ub = grid.u(b);
+                        crossings.push_back(ua + (v - va) * (ub - ua) / (vb - va));
+                    }
+                }
+            }
+            std::sort(crossings.begin(), crossings.end());
+
+            // even-odd rule
+            for (std::size_t i = 0; i + 1 < crossings.size(); i += 2) {
+                int columnStart = std::max(0, static_cast<int>(std::ceil(crossings[i] - 0.5)));
+                int columnEnd = std::min(grid.columns - 1, static_cast<int>(std::floor(crossings[i + 1] - 0.5)));
+                for (int column = columnStart; column <= columnEnd; ++column) {
+                    auto& cell = grid.cell(column, row);
+                    if (cell == CellType::Outside)
+                        cell = CellType::Inside;
+                }
+            }
+        }
+    }
+}
+
 class MeshBuilder::MeshBuilderImpl
 {
 public:
@@ -57,10 +240,8 @@ public:
         }
         else {
 
-            mid.trianglearealist = static_cast<REAL *>(malloc(mid.numberoftriangles * sizeof(REAL)));
-            for (int i = 0; i < mid.numberoftriangles; ++i) {
-                mid.trianglearealist[i] = geometryOptions.area;
-            }
+            arena_.triangleAreas.assign(static_cast<std::size_t>(mid.numberoftriangles), geometryOptions.area);
+            mid.trianglearealist = arena_.triangleAreas.data();
 
             triangulateio out;
             out.pointlist = nullptr;
@@ -74,6 +255,7 @@ public:
                 triOptions += "Y";
             }
             ::triangulate(const_cast<char*>(triOptions.c_str()), &mid, &out, nullptr);
+            mid.trianglearealist = nullptr;
 
             fillMesh(&out, mesh, geometryOptions, appearanceOptions);
 
@@ -89,21 +271,64 @@ public:
         free(mid.pointlist);
         free(mid.pointmarkerlist);
         free(mid.trianglelist);
-        free(mid.trianglearealist);
         free(mid.segmentlist);
         free(mid.segmentmarkerlist);
     }
 
+    void addGrid(Mesh& mesh, Polygon& polygon, const GeometryOptions& geometryOptions, const AppearanceOptions& appearanceOptions) const
+    {
+        // two triangles of one cell have the same area as max triangle area.
+        auto step = static_cast<ClipperLib::cInt>(std::sqrt(2 * geometryOptions.area) * Scale);
+        if (step <= 0 || polygon.outers.empty()) {
+            addPolygon(mesh, polygon, geometryOptions, appearanceOptions);
+            return;
+        }
+
+        auto paths = toPaths(polygon);
+
+        // NOTE grid is aligned to tile corner, so all regions use the same grid lines.
+        auto originX = static_cast<ClipperLib::cInt>(std::round(bbox_.minPoint.longitude * Scale));
+        auto originY = static_cast<ClipperLib::cInt>(std::round(bbox_.minPoint.latitude * Scale));
+        auto minX = paths[0][0].X, maxX = minX, minY = paths[0][0].Y, maxY = minY;
+        for (const auto& path : paths)
+            for (const auto& p : path) {
+                minX = std::min(minX, p.X); maxX = std::max(maxX, p.X);
+                minY = std::min(minY, p.Y); maxY = std::max(maxY, p.Y);
+            }
+
+        auto startX = floorDiv(minX - originX, step);
+        auto startY = floorDiv(minY - originY, step);
+        auto columns = floorDiv(maxX - originX + step - 1, step) - startX;
+        auto rows = floorDiv(maxY - originY + step - 1, step) - startY;
+        if (columns <= 0 || rows <= 0 || static_cast<std::size_t>(columns * rows) > MaxGridCells) {
+            addPolygon(mesh, polygon, geometryOptions, appearanceOptions);
+            return;
+        }
+
+        Grid grid { originX + startX * step, originY + startY * step, step,
+                    static_cast<int>(columns), static_cast<int>(rows),
+                    std::vector<CellType>(static_cast<std::size_t>(columns * rows), CellType::Outside) };
+        markBoundaryCells(paths, grid);
+        markInsideCells(paths, grid);
+
+        fillGrid(grid, mesh, geometryOptions, appearanceOptions);
+        triangulateBoundary(grid, paths, mesh, geometryOptions, appearanceOptions);
+    }
+
     void addPlane(Mesh& mesh, const Vector2& p1, const Vector2& p2,
         const GeometryOptions& geometryOptions, const AppearanceOptions& appearanceOptions) const
     {
         bool hasElevation = geometryOptions.elevation > std::numeric_limits<double>::lowest();
 
-        double ele1 = hasElevation ? geometryOptions.elevation : eleProvider_.getElevation(quadKey_, p1.y, p1.x);
-        double ele2 = hasElevation ? geometryOptions.elevation : eleProvider_.getElevation(quadKey_, p2.y, p2.x);
+        double elevations[2] = { geometryOptions.elevation, geometryOptions.elevation };
+        if (!hasElevation) {
+            const double latitudes[2] = { p1.y, p2.y };
+            const double longitudes[2] = { p1.x, p2.x };
+            eleProvider_.getElevations(quadKey_, latitudes, longitudes, elevations, 2);
+        }
 
-        ele1 += NoiseUtils::perlin2D(p1.x, p1.y, geometryOptions.eleNoiseFreq);
-        ele2 += NoiseUtils::perlin2D(p2.x, p2.y, geometryOptions.eleNoiseFreq);
+        double ele1 = elevations[0] + NoiseUtils::perlin2D(p1.x, p1.y, geometryOptions.eleNoiseFreq);
+        double ele2 = elevations[1] + NoiseUtils::perlin2D(p2.x, p2.y, geometryOptions.eleNoiseFreq);
 
         addPlane(mesh, Vector3(p1.x, ele1, p1.y), Vector3(p2.x, ele2, p2.y), geometryOptions, appearanceOptions);
     }
@@ -204,19 +429,26 @@ private:
         int triStartIndex = static_cast<int>(mesh.vertices.size() / 3);
 
         // prepare texture data
-        const auto map = createMapFunc(appearanceOptions);
+        const auto map = createTextureMapper(appearanceOptions);
 
         ensureMeshCapacity(mesh, static_cast<std::size_t>(io->numberofpoints),
                                  static_cast<std::size_t>(io->numberoftriangles));
 
+        // set colors for all points at once
+        std::size_t colorStart = mesh.colors.size();
+        mesh.colors.resize(colorStart + static_cast<std::size_t>(io->numberofpoints));
+        GradientUtils::getColors(appearanceOptions.gradient, io->pointlist, static_cast<std::size_t>(io->numberofpoints),
+                                 appearanceOptions.colorNoiseFreq, mesh.colors.data() + colorStart);
+
+        // get elevations for all points at once
+        const auto& elevations = getElevations(io->pointlist, static_cast<std::size_t>(io->numberofpoints), geometryOptions);
+
         for (int i = 0; i < io->numberofpoints; i++) {
             // get coordinates
             double x = io->pointlist[i * 2 + 0];
             double y = io->pointlist[i * 2 + 1];
-            
-            double ele = geometryOptions.heightOffset + (geometryOptions.elevation > std::numeric_limits<double>::lowest()
-                ? geometryOptions.elevation
-                : eleProvider_.getElevation(quadKey_, y, x));
+
+            double ele = geometryOptions.heightOffset + elevations[i];
 
             // do no apply noise on boundaries
             if (io->pointmarkerlist != nullptr && io->pointmarkerlist[i] != 1)
@@ -227,10 +459,6 @@ private:
             mesh.vertices.push_back(y);
             mesh.vertices.push_back(ele);
 
-            // set colors
-            int color = GradientUtils::getColor(appearanceOptions.gradient, x, y, appearanceOptions.colorNoiseFreq);
-            mesh.colors.push_back(color);
-
             // set textures
             const auto uv = map(x, y);
             mesh.uvs.push_back(uv.x);
@@ -249,27 +477,231 @@ private:
           }
     }
 
-    /// Creates texture mapping function.
-    std::function<Vector2(double, double)> createMapFunc(const AppearanceOptions& appearanceOptions) const
+    /// Fills mesh with cells which are inside polygon using shared grid vertices.
+    void fillGrid(const Grid& grid, Mesh& mesh, const GeometryOptions& geometryOptions, const AppearanceOptions& appearanceOptions) const
     {
-        if (appearanceOptions.textureRegion.isEmpty()) {
-            return [](double x, double y) {
-                return Vector2(0, 0);
-            };
+        int triStartIndex = static_cast<int>(mesh.vertices.size() / 3);
+        int nodeColumns = grid.columns + 1;
+        auto& nodeIndices = arena_.nodeIndices;
+        auto& nodes = arena_.nodes;
+        auto& points = arena_.points;
+        auto& triangles = arena_.triangles;
+        nodeIndices.assign(static_cast<std::size_t>(nodeColumns * (grid.rows + 1)), -1);
+        nodes.clear();
+        points.clear();
+        triangles.clear();
+
+        auto getIndex = [&](int column, int row) {
+            int& index = nodeIndices[row * nodeColumns + column];
+            if (index < 0) {
+                index = static_cast<int>(nodes.size());
+                nodes.push_back(row * nodeColumns + column);
+                points.push_back((grid.x + column * grid.step) / Scale);
+                points.push_back((grid.y + row * grid.step) / Scale);
+            }
+            return triStartIndex + index;
+        };
+
+        // NOTE the same vertex order as triangle library produces, see fillMesh.
+        auto addTriangle = [&](int v0, int v1, int v2) {
+            triangles.push_back(geometryOptions.flipSide ? v2 : v1);
+            triangles.push_back(v0);
+            triangles.push_back(geometryOptions.flipSide ? v1 : v2);
+        };
+
+        for (int row = 0; row < grid.rows; ++row)
+            for (int column = 0; column < grid.columns; ++column) {
+                if (grid.cell(column, row) != CellType::Inside)
+                    continue;
+
+                int v0 = getIndex(column, row);
+                int v1 = getIndex(column + 1, row);
+                int v2 = getIndex(column + 1, row + 1);
+                int v3 = getIndex(column, row + 1);
+                addTriangle(v0, v1, v2);
+                addTriangle(v0, v2, v3);
+            }
+
+        std::size_t pointCount = nodes.size();
+        if (pointCount == 0)
+            return;
+
+        ensureMeshCapacity(mesh, pointCount, triangles.size() / 3);
+
+        std::size_t colorStart = mesh.colors.size();
+        mesh.colors.resize(colorStart + pointCount);
+        GradientUtils::getColors(appearanceOptions.gradient, points.data(), pointCount,
+                                 appearanceOptions.colorNoiseFreq, mesh.colors.data() + colorStart);
+
+        const auto& elevations = getElevations(points.data(), pointCount, geometryOptions);
+
+        const auto map = createTextureMapper(appearanceOptions);
+        for (std::size_t i = 0; i < pointCount; ++i) {
+            double x = points[i * 2 + 0];
+            double y = points[i * 2 + 1];
+            double ele = geometryOptions.heightOffset + elevations[i];
+
+            // do not apply noise on vertices shared with boundary cells
+            if (grid.isInnerNode(nodes[i] % nodeColumns, nodes[i] / nodeColumns))
+                ele += NoiseUtils::perlin2D(x, y, geometryOptions.eleNoiseFreq);
+
+            mesh.vertices.push_back(x);
+            mesh.vertices.push_back(y);
+            mesh.vertices.push_back(ele);
+
+            const auto uv = map(x, y);
+            mesh.uvs.push_back(uv.x);
+            mesh.uvs.push_back(uv.y);
         }
 
-        double geoWidth = geoWidth_;
-        double geoHeight = geoHeight_;
-        double geoX = bbox_.minPoint.longitude;
-        double geoY = bbox_.minPoint.latitude;
+        mesh.triangles.insert(mesh.triangles.end(), triangles.begin(), triangles.end());
+    }
 
-        auto scale = appearanceOptions.textureScale;
+    /// Triangulates parts of polygon inside boundary cells at once.
+    void triangulateBoundary(const Grid& grid, const ClipperLib::Paths& paths, Mesh& mesh,
+                             const GeometryOptions& geometryOptions, const AppearanceOptions& appearanceOptions) const
+    {
+        Polygon polygon(paths.size() * 8);
+        ClipperLib::Clipper clipper;
+        for (int row = 0; row < grid.rows; ++row) {
+            auto rowStart = grid.cells.begin() + row * grid.columns;
+            if (std::find(rowStart, rowStart + grid.columns, CellType::Boundary) == rowStart + grid.columns)
+                continue;
+
+            auto yMin = grid.y + row * grid.step;
+            auto yMax = yMin + grid.step;
+
+            // NOTE clip polygon by row first to keep clipping of cells cheap.
+            ClipperLib::Paths strip;
+            clipper.Clear();
+            clipper.AddPaths(paths, ClipperLib::ptSubject, true);
+            clipper.AddPath(createRect(grid.x, yMin, grid.x + grid.columns * grid.step, yMax), ClipperLib::ptClip, true);
+            clipper.Execute(ClipperLib::ctIntersection, strip, ClipperLib::pftEvenOdd, ClipperLib::pftNonZero);
+            if (strip.empty())
+                continue;
+
+            // clip strip by runs of consecutive boundary cells
+            for (int column = 0; column < grid.columns; ++column) {
+                if (grid.cell(column, row) != CellType::Boundary)
+                    continue;
+
+                int runStart = column;
+                while (column + 1 < grid.columns && grid.cell(column + 1, row) == CellType::Boundary)
+                    ++column;
+
+                ClipperLib::Paths pieces;
+                clipper.Clear();
+                clipper.AddPaths(strip, ClipperLib::ptSubject, true);
+                clipper.AddPath(createRect(grid.x + runStart * grid.step, yMin,
+                                           grid.x + (column + 1) * grid.step, yMax), ClipperLib::ptClip, true);
+                clipper.Execute(ClipperLib::ctIntersection, pieces, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+
+                for (auto& piece : pieces)
+                    insertGridNodes(grid, yMin, yMax, piece);
+                addPaths(pieces, polygon);
+            }
+        }
 
-        return [=](double x, double y) {
-            double relX =  (x - geoX) / geoWidth;
-            double relY =  (y - geoY) / geoHeight;
-            return Vector2(relX * scale, relY * scale);
-        };
+        if (polygon.points.empty())
+            return;
+
+        // NOTE areas of inside and outside cells can be enclosed by boundary cells: mark them as holes.
+        addHolePoints(grid, polygon);
+
+        // cells are small, so refinement is not needed.
+        auto boundaryOptions = geometryOptions;
+        boundaryOptions.area = 0;
+        addPolygon(mesh, polygon, boundaryOptions, appearanceOptions);
+    }
+
+    /// Inserts grid nodes into path edges which lie on row lines, so
+    /// boundary triangles share vertices with neighbour cells.
+    static void insertGridNodes(const Grid& grid, ClipperLib::cInt yMin, ClipperLib::cInt yMax, ClipperLib::Path& path)
+    {
+        ClipperLib::Path result;
+        result.reserve(path.size());
+        for (std::size_t i = 0; i < path.size(); ++i) {
+            const auto& a = path[i];
+            const auto& b = path[(i + 1) % path.size()];
+            result.push_back(a);
+
+            if (a.Y != b.Y || (a.Y != yMin && a.Y != yMax))
+                continue;
+
+            auto first = floorDiv(std::min(a.X, b.X) - grid.x, grid.step) + 1;
+            auto last = floorDiv(std::max(a.X, b.X) - grid.x - 1, grid.step);
+            if (a.X < b.X) {
+                for (auto node = first; node <= last; ++node)
+                    result.push_back(ClipperLib::IntPoint(grid.x + node * grid.step, a.Y));
+            } else {
+                for (auto node = last; node >= first; --node)
+                    result.push_back(ClipperLib::IntPoint(grid.x + node * grid.step, a.Y));
+            }
+        }
+        path.swap(result);
+    }
+
+    /// Adds one hole point for every connected area of cells which are not boundary ones.
+    static void addHolePoints(const Grid& grid, Polygon& polygon)
+    {
+        std::vector<bool> visited(grid.cells.size(), false);
+        std::vector<int> stack;
+        for (int i = 0; i < static_cast<int>(grid.cells.size()); ++i) {
+            if (visited[i] || grid.cells[i] == CellType::Boundary)
+                continue;
+
+            polygon.holes.push_back((grid.x + (i % grid.columns + 0.5) * grid.step) / Scale);
+            polygon.holes.push_back((grid.y + (i / grid.columns + 0.5) * grid.step) / Scale);
+
+            visited[i] = true;
+            stack.push_back(i);
+            while (!stack.empty()) {
+                int current = stack.back();
+                stack.pop_back();
+                int column = current % grid.columns;
+                int neighbours[] = {
+                    column > 0 ? current - 1 : -1,
+                    column < grid.columns - 1 ? current + 1 : -1,
+                    current - grid.columns,
+                    current + grid.columns
+                };
+                for (int next : neighbours) {
+                    if (next < 0 || next >= static_cast<int>(grid.cells.size()) ||
+                        visited[next] || grid.cells[next] == CellType::Boundary)
+                        continue;
+                    visited[next] = true;
+                    stack.push_back(next);
+                }
+            }
+        }
+    }
+
+    /// Returns elevations for given points stored as (x, y) pairs.
+    /// NOTE result is stored in arena and valid till next call.
+    const std::vector<double>& getElevations(const double* points, std::size_t pointCount, const GeometryOptions& geometryOptions) const
+    {
+        auto& elevations = arena_.elevations;
+        elevations.assign(pointCount, geometryOptions.elevation);
+        if (geometryOptions.elevation > std::numeric_limits<double>::lowest())
+            return elevations;
+
+        auto& latitudes = arena_.latitudes;
+        auto& longitudes = arena_.longitudes;
+        latitudes.resize(pointCount);
+        longitudes.resize(pointCount);
+        for (std::size_t i = 0; i < pointCount; ++i) {
+            longitudes[i] = points[i * 2 + 0];
+            latitudes[i] = points[i * 2 + 1];
+        }
+        eleProvider_.getElevations(quadKey_, latitudes.data(), longitudes.data(), elevations.data(), pointCount);
+        return elevations;
+    }
+
+    /// Creates texture mapper.
+    TextureMapper createTextureMapper(const AppearanceOptions& appearanceOptions) const
+    {
+        return TextureMapper { bbox_.minPoint.longitude, bbox_.minPoint.latitude, geoWidth_, geoHeight_,
+                               appearanceOptions.textureScale, appearanceOptions.textureRegion.isEmpty() };
     }
 
     static void ensureMeshCapacity(Mesh& mesh, std::size_t pointCount, std::size_t triCount)
@@ -285,6 +717,7 @@ private:
     double geoWidth_;
     double geoHeight_;
     const ElevationProvider& eleProvider_;
+    mutable MeshingArena arena_;
 };
 
 MeshBuilder::MeshBuilder(const utymap::QuadKey& quadKey, const ElevationProvider& eleProvider) :
@@ -300,6 +733,12 @@ void MeshBuilder::addPolygon(Mesh& mesh, Polygon& polygon,
     pimpl_->addPolygon(mesh, polygon, geometryOptions, appearanceOptions);
 }
 
+void MeshBuilder::addGrid(Mesh& mesh, Polygon& polygon,
+                          const GeometryOptions& geometryOptions, const AppearanceOptions& appearanceOptions) const
+{
+    pimpl_->addGrid(mesh, polygon, geometryOptions, appearanceOptions);
+}
+
 void MeshBuilder::addPlane(Mesh& mesh, const Vector2& p1, const Vector2& p2,
                            const GeometryOptions& geometryOptions, const AppearanceOptions& appearanceOptions) const
 {
@@ -103,6 +103,14 @@ public:
                     const GeometryOptions& geometryOptions,
                     const AppearanceOptions& appearanceOptions) const;
 
+    /// Adds polygon to existing mesh using regular grid instead of refinement.
+    /// Grid cell size is derived from max area option. Cells inside polygon are
+    /// filled with two triangles each, only cells crossed by polygon boundary are triangulated.
+    void addGrid(utymap::math::Mesh& mesh,
+                 utymap::math::Polygon& polygon,
+                 const GeometryOptions& geometryOptions,
+                 const AppearanceOptions& appearanceOptions) const;
+
     /// Adds simple plane to existing mesh using options provided.
     void addPlane(utymap::math::Mesh& mesh,
                   const utymap::math::Vector2& p1,
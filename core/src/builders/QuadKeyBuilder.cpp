@@ -1,6 +1,7 @@
 #include "builders/BuilderContext.hpp"
 #include "builders/ExternalBuilder.hpp"
 #include "builders/QuadKeyBuilder.hpp"
+#include "utils/CancellationToken.hpp"
 #include "utils/CoreUtils.hpp"
 
 using namespace utymap;
@@ -10,6 +11,7 @@ using namespace utymap::heightmap;
 using namespace utymap::index;
 using namespace utymap::mapcss;
 using namespace utymap::math;
+using namespace utymap::utils;
 
 namespace {
     const std::string BuilderKeyName = "builders";
@@ -31,10 +33,12 @@ public:
                            const MeshCallback& meshFunc,
                            const ElementCallback& elementFunc,
                            BuilderFactoryMap& builderFactoryMap,
-                           std::uint32_t builderKeyId) :
+                           std::uint32_t builderKeyId,
+                           const CancellationToken& cancelToken) :
         context_(quadKey, styleProvider, stringTable, eleProvider, meshFunc, elementFunc),
         builderFactoryMap_(builderFactoryMap),
-        builderKeyId_(builderKeyId)
+        builderKeyId_(builderKeyId),
+        cancelToken_(cancelToken)
     {
     }
 
@@ -46,16 +50,23 @@ public:
 
     void visitRelation(const Relation& relation) override { visitElement(relation); }
 
+    /// Completes all builders unless build is cancelled.
     void complete()
     {
-        for (const auto& builder : builders_)
+        for (const auto& builder : builders_) {
+            if (cancelToken_.isCancelled())
+                return;
             builder.second->complete();
+        }
     }
 
 private:
     /// Calls appropriate visitor for given element
     void visitElement(const Element& element)
     {
+        if (cancelToken_.isCancelled())
+            return;
+
         Style style = context_.styleProvider.forElement(element, context_.quadKey.levelOfDetail);
 
         // we don't know how to build it. Skip.
@@ -64,7 +75,7 @@ private:
 
         std::stringstream ss(style.get(builderKeyId_).value());
         std::string name;
-        while (ss.good()) {
+        while (ss.good() && !cancelToken_.isCancelled()) {
             getline(ss, name, ',');
             element.accept(getBuilder(name));
             name.clear();
@@ -92,6 +103,7 @@ private:
     const BuilderContext context_;
     BuilderFactoryMap& builderFactoryMap_;
     std::uint32_t builderKeyId_;
+    const CancellationToken& cancelToken_;
     std::unordered_map<std::string, std::unique_ptr<ElementBuilder>> builders_;
 };
 
@@ -113,10 +125,11 @@ public:
                const StyleProvider& styleProvider,
                const ElevationProvider& eleProvider,
                const MeshCallback& meshFunc,
-               const ElementCallback& elementFunc)
+               const ElementCallback& elementFunc,
+               const CancellationToken& cancelToken)
     {
         AggregateElementVisitor elementVisitor(quadKey, styleProvider, stringTable_,
-            eleProvider, meshFunc, elementFunc, builderFactory_, builderKeyId_);
+            eleProvider, meshFunc, elementFunc, builderFactory_, builderKeyId_, cancelToken);
 
         geoStore_.search(quadKey, styleProvider, elementVisitor);
         elementVisitor.complete();
@@ -137,7 +150,14 @@ void QuadKeyBuilder::registerElementBuilder(const std::string& name, ElementBuil
 void QuadKeyBuilder::build(const QuadKey& quadKey, const StyleProvider& styleProvider, const ElevationProvider& eleProvider, 
     MeshCallback meshFunc, ElementCallback elementFunc)
 {
-    pimpl_->build(quadKey, styleProvider, eleProvider, meshFunc, elementFunc);
+    CancellationToken cancelToken;
+    pimpl_->build(quadKey, styleProvider, eleProvider, meshFunc, elementFunc, cancelToken);
+}
+
+void QuadKeyBuilder::build(const QuadKey& quadKey, const StyleProvider& styleProvider, const ElevationProvider& eleProvider,
+    MeshCallback meshFunc, ElementCallback elementFunc, const CancellationToken& cancelToken)
+{
+    pimpl_->build(quadKey, styleProvider, eleProvider, meshFunc, elementFunc, cancelToken);
 }
 
 QuadKeyBuilder::QuadKeyBuilder(GeoStore& geoStore, StringTable& stringTable) :
@@ -9,6 +9,7 @@
 #include "index/GeoStore.hpp"
 #include "mapcss/StyleProvider.hpp"
 #include "math/Mesh.hpp"
+#include "utils/CancellationToken.hpp"
 
 #include <functional>
 #include <string>
@@ -30,15 +31,26 @@ public:
     ~QuadKeyBuilder();
 
     /// Registers factory method for element builder.
+    /// NOTE should not be called while tiles are being built.
     void registerElementBuilder(const std::string& name, ElementBuilderFactory factory);
 
-    /// Builds tile for given quadkey.
+    /// Builds tile for given quadkey. Can be called from multiple threads for
+    /// different quadkeys: every call uses its own builder instances.
     void build(const utymap::QuadKey& quadKey,
                const utymap::mapcss::StyleProvider& styleProvider,
                const utymap::heightmap::ElevationProvider& eleProvider,
                MeshCallback meshFunc,
                ElementCallback elementFunc);
 
+    /// Builds tile for given quadkey. Cancellation is checked between elements and builders,
+    /// so cancelled build stops early and may report only part of tile.
+    void build(const utymap::QuadKey& quadKey,
+               const utymap::mapcss::StyleProvider& styleProvider,
+               const utymap::heightmap::ElevationProvider& eleProvider,
+               MeshCallback meshFunc,
+               ElementCallback elementFunc,
+               const utymap::utils::CancellationToken& cancelToken);
+
 private:
     class QuadKeyBuilderImpl;
     std::unique_ptr<QuadKeyBuilderImpl> pimpl_;
@@ -184,7 +184,12 @@ class BuildingBuilder::BuildingBuilderImpl : public ElementBuilder
 public:
     explicit BuildingBuilderImpl(const utymap::builders::BuilderContext& context) :
         ElementBuilder(context),
-        id_(0)
+        id_(0),
+        buildingKey_(context.stringTable.getId("building")),
+        multipolygonKey_(context.stringTable.getId("multipolygon")),
+        heightKey_(context.stringTable.getId(StyleConsts::HeightKey())),
+        minHeightKey_(context.stringTable.getId(StyleConsts::MinHeightKey())),
+        roofHeightKey_(context.stringTable.getId(RoofHeightKey))
     {
     }
 
@@ -260,26 +265,26 @@ private:
         }
     }
 
-    static bool isBuilding(const Style& style)
+    bool isBuilding(const Style& style) const
     {
-        return style.getString("building") == "true";
+        return style.getString(buildingKey_) == "true";
     }
 
-    static bool isMultipolygon(const Style& style)
+    bool isMultipolygon(const Style& style) const
     {
-        return style.getString("multipolygon") == "true";
+        return style.getString(multipolygonKey_) == "true";
     }
 
     void build(const Element& element, const Style& style)
     {
         auto geoCoordinate = GeoCoordinate(polygon_->points[1], polygon_->points[0]);
 
-        double height = style.getValue(StyleConsts::HeightKey());
+        double height = style.getValue(heightKey_);
         // NOTE do not allow height to be zero. This might happen due to the issues in input osm data.
         if (height == 0)
             height = 10;
 
-        double minHeight = style.getValue(StyleConsts::MinHeightKey());
+        double minHeight = style.getValue(minHeightKey_);
 
         double elevation = context_.eleProvider.getElevation(context_.quadKey, geoCoordinate) + minHeight;
 
@@ -293,7 +298,8 @@ private:
 
         attachFacade(*mesh_, style, elevation, height);
 
-        polygon_.reset();
+        // NOTE keep polygon's memory for next building.
+        polygon_->clear();
     }
 
     void attachRoof(Mesh& mesh, const Style& style, double elevation, double height) const
@@ -302,7 +308,7 @@ private:
             RoofGradientKey, RoofTextureIndexKey, RoofTextureTypeKey, RoofTextureScaleKey, id_);
 
         auto roofType = roofMeshContext.style.getString(RoofTypeKey);
-        double roofHeight = roofMeshContext.style.getValue(RoofHeightKey);
+        double roofHeight = roofMeshContext.style.getValue(roofHeightKey_);
         auto direction = roofMeshContext.style.getString(RoofDirectionKey);
 
         auto roofBuilder = RoofBuilderFactoryMap.find(roofType)->second(context_, roofMeshContext);
@@ -348,6 +354,12 @@ private:
     std::unique_ptr<Polygon> polygon_;
     std::unique_ptr<Mesh> mesh_;
     std::uint64_t id_;
+
+    const std::uint32_t buildingKey_;
+    const std::uint32_t multipolygonKey_;
+    const std::uint32_t heightKey_;
+    const std::uint32_t minHeightKey_;
+    const std::uint32_t roofHeightKey_;
 };
 
 BuildingBuilder::BuildingBuilder(const BuilderContext& context)
@@ -8,6 +8,7 @@
 #include <cmath>
 #include <cstdint>
 #include <limits>
+#include <vector>
 
 namespace utymap { namespace builders {
 
@@ -54,19 +55,18 @@ public:
         Point s(start.X / scale_, start.Y / scale_);
         Point e(end.X / scale_, end.Y / scale_);
 
-        Points points;
-        points.reserve(2);
-        points.push_back(s);
+        points_.clear();
+        points_.push_back(s);
 
         double slope = (e.y - s.y) / (e.x - s.x);
         if (std::isinf(slope) || std::abs(slope) < std::numeric_limits<double>::epsilon())
-            zeroSlope(s, e, points);
+            zeroSlope(s, e, points_);
         else
-            normalCase(s, e, slope, points);
+            normalCase(s, e, slope, points_);
 
-        points.push_back(e);
+        points_.push_back(e);
 
-        mergeResults(points, result);
+        mergeResults(points_, result);
     }
 
 private:
@@ -168,6 +168,8 @@ private:
 
     double scale_;
     double step_;
+    /// NOTE reused between calls to avoid allocations, so splitter is not thread safe.
+    mutable Points points_;
 };
 
 }}
@@ -5,6 +5,7 @@
 #include "builders/MeshBuilder.hpp"
 #include "mapcss/Style.hpp"
 #include "mapcss/StyleConsts.hpp"
+#include "utils/GradientUtils.hpp"
 
 #include <memory>
 
@@ -56,7 +57,7 @@ struct RegionContext final
         double scale = style.getValue(prefix + StyleConsts::TextureScaleKey());
 
         MeshBuilder::AppearanceOptions appearanceOptions(
-            context.styleProvider.getGradient(style.getString(prefix + StyleConsts::GradientKey())),
+            utymap::utils::GradientUtils::evaluateGradient(context.styleProvider, style, prefix + StyleConsts::GradientKey()),
             style.getValue(prefix + StyleConsts::ColorNoiseFreqKey(), context.boundingBox),
             textureIndex,
             textureRegion,
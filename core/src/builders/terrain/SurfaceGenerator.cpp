@@ -10,6 +10,8 @@ using namespace std::placeholders;
 
 namespace {
     const std::string TerrainMeshName = "terrain_surface";
+    /// Mesh type which uses regular grid instead of triangle refinement.
+    const std::string GridMeshType = "grid";
     const int Level = 0;
 
     const std::unordered_map<std::string, TerraExtras::ExtrasFunc> ExtrasFuncs = 
@@ -20,7 +22,8 @@ namespace {
 };
 
 SurfaceGenerator::SurfaceGenerator(const BuilderContext& context, const Style& style, const Path& tileRect) :
-TerraGenerator(context, style, tileRect, TerrainMeshName)
+TerraGenerator(context, style, tileRect, TerrainMeshName),
+useGrid_(style.getString(StyleConsts::MeshTypeKey()) == GridMeshType)
 {
 }
 
@@ -99,8 +102,7 @@ void SurfaceGenerator::addGeometry(int level, Polygon& polygon, const RegionCont
     if (!meshName.empty()) {
         Mesh polygonMesh(meshName);
         TerraExtras::Context extrasContext(polygonMesh, regionContext.style);
-        context_.meshBuilder.addPolygon(polygonMesh, polygon,
-            regionContext.geometryOptions, regionContext.appearanceOptions);
+        addPolygon(polygonMesh, polygon, regionContext);
         context_.meshBuilder.writeTextureMappingInfo(polygonMesh, regionContext.appearanceOptions);
 
         addExtrasIfNecessary(polygonMesh, extrasContext, regionContext);
@@ -108,14 +110,21 @@ void SurfaceGenerator::addGeometry(int level, Polygon& polygon, const RegionCont
     }
     else {
         TerraExtras::Context extrasContext(mesh_, regionContext.style);
-        context_.meshBuilder.addPolygon(mesh_, polygon,
-            regionContext.geometryOptions, regionContext.appearanceOptions);
+        addPolygon(mesh_, polygon, regionContext);
         context_.meshBuilder.writeTextureMappingInfo(mesh_, regionContext.appearanceOptions);
 
         addExtrasIfNecessary(mesh_, extrasContext, regionContext);
     }
 }
 
+void SurfaceGenerator::addPolygon(Mesh& mesh, Polygon& polygon, const RegionContext& regionContext) const
+{
+    if (useGrid_)
+        context_.meshBuilder.addGrid(mesh, polygon, regionContext.geometryOptions, regionContext.appearanceOptions);
+    else
+        context_.meshBuilder.addPolygon(mesh, polygon, regionContext.geometryOptions, regionContext.appearanceOptions);
+}
+
 void SurfaceGenerator::addExtrasIfNecessary(Mesh& mesh,
                                             TerraExtras::Context& extrasContext,
                                             const RegionContext& regionContext) const
@@ -41,6 +41,11 @@ private:
     /// Builds mesh using paths data.
     void buildRegion(const Region& region);
 
+    /// Adds polygon to mesh using grid or triangulation depending on canvas style.
+    void addPolygon(utymap::math::Mesh& mesh,
+                    utymap::math::Polygon& polygon,
+                    const RegionContext& regionContext) const;
+
     /// Adds extras to mesh, e.g. trees, water surface if meshExtras are specified in options.
     void addExtrasIfNecessary(utymap::math::Mesh& mesh,
                               TerraExtras::Context& extrasContext,
@@ -48,6 +53,7 @@ private:
 
     ClipperLib::ClipperEx foregroundClipper_;
     ClipperLib::ClipperEx backgroundClipper_;
+    const bool useGrid_;
 };
 
 }}
@@ -74,7 +74,10 @@ public:
     explicit TerraBuilderImpl(const BuilderContext& context) :
         ElementBuilder(context), 
         style_(context.styleProvider.forCanvas(context.quadKey.levelOfDetail)),
-        generators_(), dimenstionKey_(context.stringTable.getId(StyleConsts::DimensionKey()))
+        generators_(), dimenstionKey_(context.stringTable.getId(StyleConsts::DimensionKey())),
+        widthKey_(context.stringTable.getId(StyleConsts::WidthKey())),
+        levelKey_(context.stringTable.getId(StyleConsts::LevelKey())),
+        terrainLayerKey_(context.stringTable.getId(StyleConsts::TerrainLayerKey()))
     {
         tileRect_.push_back(toIntPoint(context.boundingBox.minPoint.longitude, context.boundingBox.minPoint.latitude));
         tileRect_.push_back(toIntPoint(context.boundingBox.maxPoint.longitude, context.boundingBox.minPoint.latitude));
@@ -112,7 +115,7 @@ public:
        
         region->geometry = solution;
         std::string type = region->isLayer()
-            ? style.getString(StyleConsts::TerrainLayerKey())
+            ? style.getString(terrainLayerKey_)
             : "";
 
         addRegion(type, way, style, region);
@@ -123,7 +126,7 @@ public:
         Style style = context_.styleProvider.forElement(area, context_.quadKey.levelOfDetail);
         auto region = createRegion(style, area.coordinates);
         std::string type = region->isLayer()
-            ? style.getString(StyleConsts::TerrainLayerKey())
+            ? style.getString(terrainLayerKey_)
             : "";
 
         addRegion(type, area, style, region);
@@ -145,11 +148,11 @@ public:
 
         if (!region->geometry.empty()) {
             Style style = context_.styleProvider.forElement(rel, context_.quadKey.levelOfDetail);
-            if (!style.has(context_.stringTable.getId(StyleConsts::TerrainLayerKey())))
+            if (!style.has(terrainLayerKey_))
                 region->context = utymap::utils::make_unique<RegionContext>(RegionContext::create(context_, style, ""));
 
             std::string type = region->isLayer()
-                ? style.getString(StyleConsts::TerrainLayerKey())
+                ? style.getString(terrainLayerKey_)
                 : "";
 
             addRegion(type, rel, style, region);
@@ -179,9 +182,9 @@ private:
     {
         // NOTE current mapcss does not support double value evaluation with dimension
         // so, special trick with mapcss key is used.
-        double value = style.getValue(StyleConsts::WidthKey(), context_.boundingBox);
+        double value = style.getValue(widthKey_, context_.boundingBox);
         return style.has(dimenstionKey_)
-            ? value * style.getValue(StyleConsts::DimensionKey(), context_.boundingBox)
+            ? value * style.getValue(dimenstionKey_, context_.boundingBox)
             : value;
     }
 
@@ -204,10 +207,10 @@ private:
 
         region->geometry.push_back(path);
 
-        if (!style.has(context_.stringTable.getId(StyleConsts::TerrainLayerKey())))
+        if (!style.has(terrainLayerKey_))
             region->context = std::make_shared<RegionContext>(RegionContext::create(context_, style, ""));
 
-        region->level = static_cast<int>(style.getValue(StyleConsts::LevelKey()));
+        region->level = static_cast<int>(style.getValue(levelKey_));
         return region;
     }
 
@@ -247,6 +250,9 @@ private:
     Layers layers_;
     Path tileRect_;
     std::uint32_t dimenstionKey_;
+    std::uint32_t widthKey_;
+    std::uint32_t levelKey_;
+    std::uint32_t terrainLayerKey_;
 };
 
 void TerraBuilder::visitNode(const utymap::entities::Node& node) { pimpl_->visitNode(node); }
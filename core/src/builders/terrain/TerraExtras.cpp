@@ -27,10 +27,10 @@ void TerraExtras::addForest(const BuilderContext& builderContext, TerraExtras::C
     // forest mesh contains all trees belong to one chunk.
     Mesh forestMesh("forest");
 
-    // go through mesh region triangles and insert copy of the tree
+    // go through mesh region triangles and collect tree positions
     std::size_t step = 3 * static_cast<std::size_t>(std::max(extrasContext.style.getValue(TreeFrequencyKey), 1.));
     int chunkSize = static_cast<int>(std::max(extrasContext.style.getValue(TreeChunkSize), 1.));
-    int treesProcessed = 0;
+    std::vector<double> latitudes, longitudes;
     for (auto i = extrasContext.startTriangle; i < extrasContext.mesh.triangles.size(); i += step) {
         double centroidX = 0;
         double centroidY = 0;
@@ -40,12 +40,18 @@ void TerraExtras::addForest(const BuilderContext& builderContext, TerraExtras::C
             centroidY += extrasContext.mesh.vertices[index + 1];
         }
 
-        centroidX /= 3;
-        centroidY /= 3;
+        longitudes.push_back(centroidX / 3);
+        latitudes.push_back(centroidY / 3);
+    }
 
-        double elevation = builderContext.eleProvider.getElevation(builderContext.quadKey, centroidY, centroidX);
+    std::vector<double> elevations(latitudes.size());
+    builderContext.eleProvider.getElevations(builderContext.quadKey, latitudes.data(), longitudes.data(),
+                                             elevations.data(), elevations.size());
 
-        utymap::utils::copyMesh(Vector3(centroidX - center.longitude, elevation, centroidY - center.latitude), treeMesh, forestMesh);
+    // insert copy of the tree at every position
+    int treesProcessed = 0;
+    for (std::size_t i = 0; i < elevations.size(); ++i) {
+        utymap::utils::copyMesh(Vector3(longitudes[i] - center.longitude, elevations[i], latitudes[i] - center.latitude), treeMesh, forestMesh);
         // return chunk if necessary.
         if (++treesProcessed == chunkSize) {
             builderContext.meshCallback(forestMesh);
@@ -22,7 +22,8 @@ TerraGenerator::TerraGenerator(const utymap::builders::BuilderContext& context,
                                rect_(context.boundingBox.minPoint.longitude,
                                      context.boundingBox.minPoint.latitude,
                                      context.boundingBox.maxPoint.longitude,
-                                     context.boundingBox.maxPoint.latitude)
+                                     context.boundingBox.maxPoint.latitude),
+                               polygon_(0, 0)
 {
     auto size = style_.getValue(StyleConsts::GridCellSize(), context_.boundingBox);
     splitter_.setParams(Scale, size);
@@ -34,12 +35,8 @@ void TerraGenerator::addGeometry(int level, Paths& geometry, const RegionContext
     ClipperLib::CleanPolygons(geometry);
 
     bool hasHeightOffset = std::abs(regionContext.geometryOptions.heightOffset) > 0;
-    // calculate approximate size of overall points
-    double size = 0;
-    for (std::size_t i = 0; i < geometry.size(); ++i)
-        size += geometry[i].size() * 1.5;
 
-    Polygon polygon(static_cast<std::size_t>(size));
+    polygon_.clear();
     for (const Path& path : geometry) {
         double area = ClipperLib::Area(path);
         bool isHole = area < 0;
@@ -48,18 +45,18 @@ void TerraGenerator::addGeometry(int level, Paths& geometry, const RegionContext
 
         geometryVisitor(path);
 
-        auto points = restoreGeometry(path);
+        restoreGeometry(path, points_);
         if (isHole)
-            polygon.addHole(points);
+            polygon_.addHole(points_);
         else
-            polygon.addContour(points);
+            polygon_.addContour(points_);
 
         if (hasHeightOffset)
-            buildHeightOffset(points, regionContext);
+            buildHeightOffset(points_, regionContext);
     }
 
-    if (!polygon.points.empty())
-        addGeometry(level, polygon, regionContext);
+    if (!polygon_.points.empty())
+        addGeometry(level, polygon_, regionContext);
 }
 
 void TerraGenerator::buildHeightOffset(const std::vector<Vector2>& points, const RegionContext& regionContext)
@@ -80,13 +77,10 @@ void TerraGenerator::buildHeightOffset(const std::vector<Vector2>& points, const
     }
 }
 
-std::vector<Vector2> TerraGenerator::restoreGeometry(const Path& geometry) const
+void TerraGenerator::restoreGeometry(const Path& geometry, std::vector<Vector2>& points) const
 {
     auto lastItemIndex = geometry.size() - 1;
-    std::vector<utymap::math::Vector2> points;
-    points.reserve(geometry.size());
+    points.clear();
     for (std::size_t i = 0; i <= lastItemIndex; i++)
         splitter_.split(geometry[i], geometry[i == lastItemIndex ? 0 : i + 1], points);
-
-    return std::move(points);
 }
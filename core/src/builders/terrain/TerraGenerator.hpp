@@ -55,11 +55,14 @@ private:
     /// Builds height contour shape.
     void buildHeightOffset(const std::vector<utymap::math::Vector2>& points, const RegionContext& regionContext);
 
-    /// Restores geometry from clipper format.
-    std::vector<utymap::math::Vector2> restoreGeometry(const ClipperLib::Path& geometry) const;
+    /// Restores geometry from clipper format into given points.
+    void restoreGeometry(const ClipperLib::Path& geometry, std::vector<utymap::math::Vector2>& points) const;
 
     const utymap::math::Rectangle rect_;
     utymap::builders::LineGridSplitter splitter_;
+    /// NOTE buffers are reused between regions to avoid allocations.
+    utymap::math::Polygon polygon_;
+    std::vector<utymap::math::Vector2> points_;
 };
 
 }}
@@ -9,6 +9,8 @@ struct Area;
 struct Relation;
 
 /// A base class for visiting entities - elements.
+/// NOTE visited element is guaranteed to be valid only during visit call as
+/// element stores may reuse its memory: copy element if ownership is needed.
 class ElementVisitor
 {
 public:
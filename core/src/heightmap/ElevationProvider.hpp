@@ -4,6 +4,8 @@
 #include "GeoCoordinate.hpp"
 #include "QuadKey.hpp"
 
+#include <cstddef>
+
 namespace utymap { namespace heightmap {
 
 /// Provides the way to get elevation for given location.
@@ -16,6 +18,15 @@ public:
     /// Gets elevation for given geocoordinate.
     virtual double getElevation(const QuadKey& quadkey, double latitude, double longitude) const = 0;
 
+    /// Gets elevations for count locations specified by separate arrays of latitudes and
+    /// longitudes. Default implementation queries locations one by one.
+    virtual void getElevations(const QuadKey& quadkey, const double* latitudes, const double* longitudes,
+                               double* elevations, std::size_t count) const
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            elevations[i] = getElevation(quadkey, latitudes[i], longitudes[i]);
+    }
+
     virtual ~ElevationProvider() = default;
 };
 
@@ -3,6 +3,8 @@
 
 #include "heightmap/ElevationProvider.hpp"
 
+#include <algorithm>
+
 namespace utymap { namespace heightmap {
 
 /// Simple implementation of ElevationProvider which returns zero for all places.
@@ -19,6 +21,11 @@ public:
     { 
         return 0; 
     };
+
+    void getElevations(const utymap::QuadKey&, const double*, const double*, double* elevations, std::size_t count) const override
+    {
+        std::fill(elevations, elevations + count, 0);
+    }
 };
 
 }}
@@ -0,0 +1,156 @@
+#include "hashing/MurmurHash3.h"
+#include "heightmap/GridElevationConverter.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+using namespace utymap;
+using namespace utymap::heightmap;
+
+const std::uint32_t GridElevationConverter::Magic;
+const std::uint32_t GridElevationConverter::Version;
+const std::uint32_t GridElevationConverter::ByteOrderMark;
+
+namespace {
+
+/// Reads whole content of given file.
+bool readFile(const std::string& path, std::string& content)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.good())
+        return false;
+
+    content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !file.bad();
+}
+
+/// Calculates hash of given content.
+void getHash(const std::string& content, std::uint64_t hash[2])
+{
+    MurmurHash3_x64_128(content.data(), static_cast<int>(content.size()), 0, hash);
+}
+
+/// Parses heights of text grid from given stream.
+std::vector<std::int16_t> parseHeights(std::istream& stream, const std::string& textPath)
+{
+    std::vector<std::int16_t> heights;
+    std::for_each(std::istream_iterator<int>(stream), std::istream_iterator<int>(), [&](int height) {
+        if (height < std::numeric_limits<std::int16_t>::min() || height > std::numeric_limits<std::int16_t>::max())
+            throw std::domain_error("Elevation is out of range in:" + textPath);
+        heights.push_back(static_cast<std::int16_t>(height));
+    });
+
+    if (heights.empty())
+        throw std::domain_error("Cannot get elevation data from:" + textPath);
+
+    auto size = static_cast<std::size_t>(std::sqrt(heights.size()));
+    if (size < 2 || size * size != heights.size())
+        throw std::domain_error("Elevation grid is not square in:" + textPath);
+
+    return heights;
+}
+
+}
+
+std::vector<std::int16_t> GridElevationConverter::parse(const std::string& textPath)
+{
+    std::ifstream file(textPath);
+    if (!file.good())
+        throw std::invalid_argument(std::string("Cannot find elevation file:") + textPath);
+
+    return parseHeights(file, textPath);
+}
+
+bool GridElevationConverter::convert(const std::string& textPath, const std::string& binaryPath, const BoundingBox& bbox)
+{
+    namespace fs = boost::filesystem;
+
+    // NOTE time is taken before content is read, so concurrent rewrite is detected later.
+    boost::system::error_code ec;
+    std::time_t sourceTime = fs::last_write_time(textPath, ec);
+    std::string content;
+    if (ec || !readFile(textPath, content))
+        throw std::invalid_argument(std::string("Cannot find elevation file:") + textPath);
+
+    std::istringstream stream(content);
+    auto heights = parseHeights(stream, textPath);
+
+    Header header;
+    header.magic = Magic;
+    header.version = Version;
+    header.resolution = static_cast<std::int32_t>(std::sqrt(heights.size())) - 1;
+    header.byteOrder = ByteOrderMark;
+    header.minLatitude = bbox.minPoint.latitude;
+    header.minLongitude = bbox.minPoint.longitude;
+    header.maxLatitude = bbox.maxPoint.latitude;
+    header.maxLongitude = bbox.maxPoint.longitude;
+    header.sourceSize = content.size();
+    header.sourceTime = static_cast<std::int64_t>(sourceTime);
+    getHash(content, header.sourceHash);
+
+    // NOTE write to temporary file first, so readers never see partially written grid.
+    std::string tempPath = binaryPath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.good())
+            return false;
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        file.write(reinterpret_cast<const char*>(heights.data()), heights.size() * sizeof(std::int16_t));
+        if (!file.good()) {
+            file.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+    std::remove(binaryPath.c_str());
+    return std::rename(tempPath.c_str(), binaryPath.c_str()) == 0;
+}
+
+bool GridElevationConverter::isValid(const Header& header, std::size_t fileSize)
+{
+    if (header.magic != Magic || header.version != Version ||
+        header.byteOrder != ByteOrderMark || header.resolution < 1)
+        return false;
+
+    std::size_t cellSize = static_cast<std::size_t>(header.resolution) + 1;
+    return fileSize == sizeof(Header) + cellSize * cellSize * sizeof(std::int16_t);
+}
+
+bool GridElevationConverter::isUpToDate(const Header& header, const std::string& textPath, const std::string& binaryPath)
+{
+    namespace fs = boost::filesystem;
+
+    boost::system::error_code ec;
+    auto sourceSize = fs::file_size(textPath, ec);
+    if (ec || header.sourceSize != sourceSize)
+        return false;
+
+    std::time_t sourceTime = fs::last_write_time(textPath, ec);
+    if (ec || header.sourceTime != static_cast<std::int64_t>(sourceTime))
+        return false;
+
+    // NOTE write time has low resolution, so text file rewritten in the same tick
+    // when binary file is created cannot be detected by time: compare content instead.
+    std::time_t binaryTime = fs::last_write_time(binaryPath, ec);
+    if (!ec && sourceTime < binaryTime)
+        return true;
+
+    std::string content;
+    if (!readFile(textPath, content))
+        return false;
+
+    std::uint64_t hash[2];
+    getHash(content, hash);
+    return hash[0] == header.sourceHash[0] && hash[1] == header.sourceHash[1];
+}
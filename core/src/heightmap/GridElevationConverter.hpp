@@ -0,0 +1,62 @@
+#ifndef HEIGHTMAP_GRIDELEVATIONCONVERTER_HPP_DEFINED
+#define HEIGHTMAP_GRIDELEVATIONCONVERTER_HPP_DEFINED
+
+#include "BoundingBox.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace utymap { namespace heightmap {
+
+/// Converts elevation grid from text format (whitespace separated integers) to binary one.
+/// Binary format is header followed by heights stored as native int16 values row by row
+/// starting from south west corner. It can be memory mapped and used without parsing.
+/// Header keeps byte order of the file, so it is rejected on machine with another one.
+/// Header also keeps size, last write time and content hash of text file, so stale binary
+/// file can be detected.
+class GridElevationConverter final
+{
+public:
+    /// Header of binary elevation grid file.
+    struct Header
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        /// Amount of cells in one row, so each row has resolution + 1 heights.
+        std::int32_t resolution;
+        /// Byte order mark written in native byte order of machine which created file.
+        std::uint32_t byteOrder;
+        double minLatitude;
+        double minLongitude;
+        double maxLatitude;
+        double maxLongitude;
+        /// Size of text file in bytes.
+        std::uint64_t sourceSize;
+        /// Last write time of text file.
+        std::int64_t sourceTime;
+        /// 128 bit hash of text file content.
+        std::uint64_t sourceHash[2];
+    };
+
+    static const std::uint32_t Magic = 0x47455455; // UTEG
+    static const std::uint32_t Version = 3;
+    static const std::uint32_t ByteOrderMark = 0x01020304;
+
+    /// Parses heights of elevation grid stored in text format.
+    static std::vector<std::int16_t> parse(const std::string& textPath);
+
+    /// Converts text elevation grid which covers given bounding box into binary file.
+    /// Returns false if binary file cannot be written.
+    static bool convert(const std::string& textPath, const std::string& binaryPath, const utymap::BoundingBox& bbox);
+
+    /// Checks whether header is valid for binary file of given size.
+    static bool isValid(const Header& header, std::size_t fileSize);
+
+    /// Checks whether binary file with given header is converted from current content of text file.
+    static bool isUpToDate(const Header& header, const std::string& textPath, const std::string& binaryPath);
+};
+
+}}
+
+#endif // HEIGHTMAP_GRIDELEVATIONCONVERTER_HPP_DEFINED
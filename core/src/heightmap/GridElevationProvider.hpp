@@ -2,23 +2,31 @@
 #define HEIGHTMAP_GRIDELEVATIONPROVIDER_HPP_DEFINED
 
 #include "heightmap/ElevationProvider.hpp"
-#include "utils/CoreUtils.hpp"
+#include "heightmap/GridElevationConverter.hpp"
 #include "utils/GeoUtils.hpp"
+#include "utils/LruCache.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 #include <algorithm>
 #include <cmath>
-#include <fstream>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <stdexcept>
 #include <sstream>
-#include <map>
-#include <mutex>
+#include <memory>
 #include <vector>
 
 namespace utymap { namespace heightmap {
 
-/// Provides the way to get elevation for given location from grid 
-/// represented by comma separated list of integers
+/// Provides the way to get elevation for given location from grid.
+/// Grid is stored in binary file which is memory mapped. The file is created
+/// from text grid represented by whitespace separated list of integers when
+/// it is missing or converted from another version of text one. Loaded grids are
+/// kept in LRU cache of limited size.
 class GridElevationProvider final : public ElevationProvider
 {
     /// Holds elevation data information.
@@ -30,14 +38,23 @@ class GridElevationProvider final : public ElevationProvider
         int yStep = 0;
         int resolution = 0;
 
-        std::vector<int> heights;
+        const std::int16_t* heights = nullptr;
+
+        /// Owns heights when binary file cannot be written.
+        std::vector<std::int16_t> buffer;
+        boost::interprocess::file_mapping file;
+        boost::interprocess::mapped_region region;
     };
 
+    typedef utymap::utils::LruCache<QuadKey, EleData> DataCache;
+    typedef DataCache::ValuePtr EleDataPtr;
+
     const double Scale = 1E7;
 
 public:
-    GridElevationProvider(std::string dataDirectory) :
-        data_(), dataDirectory_(dataDirectory)
+    GridElevationProvider(std::string dataDirectory, int maxCacheSize = 16) :
+        data_(static_cast<std::size_t>(std::max(maxCacheSize, 1))),
+        dataDirectory_(dataDirectory)
     {
     }
 
@@ -50,31 +67,54 @@ public:
     /// Gets elevation for given geocoordinate.
     double getElevation(const utymap::QuadKey& quadKey, double latitude, double longitude) const override
     {
-        auto data = data_.find(quadKey);
-        if (data == data_.end()) {
-            preload(quadKey);
-            data = data_.find(quadKey);
-        }
+        return interpolate(*getData(quadKey), latitude, longitude);
+    }
+
+    /// Gets elevations for given geocoordinates resolving elevation data only once.
+    void getElevations(const utymap::QuadKey& quadKey, const double* latitudes, const double* longitudes,
+                       double* elevations, std::size_t count) const override
+    {
+        auto data = getData(quadKey);
+        for (std::size_t i = 0; i < count; ++i)
+            elevations[i] = interpolate(*data, latitudes[i], longitudes[i]);
+    }
 
-        int resolution = data->second.resolution;
+    /// Returns amount of currently loaded grids.
+    std::size_t getCacheSize() const
+    {
+        return data_.size();
+    }
+
+    /// Gets path to binary grid file of given quadkey.
+    std::string getBinaryFilePath(const QuadKey& quadKey) const
+    {
+        return getFilePath(quadKey) + ".bin";
+    }
+
+private:
 
-        int x = static_cast<int>(longitude * Scale) - data->second.xStart;
-        int y = static_cast<int>(latitude * Scale) - data->second.yStart;
+    /// Interpolates elevation for given geocoordinate using elevation data.
+    double interpolate(const EleData& data, double latitude, double longitude) const
+    {
+        int resolution = data.resolution;
 
-        int x0 = clamp(x / data->second.xStep, 0, resolution);
-        int y0 = clamp(y / data->second.yStep, 0, resolution);
+        int x = static_cast<int>(longitude * Scale) - data.xStart;
+        int y = static_cast<int>(latitude * Scale) - data.yStart;
+
+        int x0 = clamp(x / data.xStep, 0, resolution);
+        int y0 = clamp(y / data.yStep, 0, resolution);
 
         int x1 = std::min(x0 + 1, resolution);
         int y1 = std::min(y0 + 1, resolution);
 
-        double dx = static_cast<double>(x - x0 * data->second.xStep) / data->second.xStep;
-        double dy = static_cast<double>(y - y0 * data->second.yStep) / data->second.yStep;
+        double dx = static_cast<double>(x - x0 * data.xStep) / data.xStep;
+        double dy = static_cast<double>(y - y0 * data.yStep) / data.yStep;
 
         int cellSize = resolution + 1;
-        int height2 = data->second.heights[x0 + y0 * cellSize];
-        int height0 = data->second.heights[x0 + y1 * cellSize];
-        int height3 = data->second.heights[x1 + y0 * cellSize];
-        int height1 = data->second.heights[x1 + y1 * cellSize];
+        int height2 = data.heights[x0 + y0 * cellSize];
+        int height0 = data.heights[x0 + y1 * cellSize];
+        int height3 = data.heights[x1 + y0 * cellSize];
+        int height1 = data.heights[x1 + y1 * cellSize];
 
         // Bilinear interpolation
         // h0------------h1
@@ -88,49 +128,91 @@ public:
         return height0*dy*(1 - dx) + height1*dy*(dx)+height2*(1 - dy)*(1 - dx) + height3*(1 - dy)*dx;
     }
 
-private:
-
     static int clamp(int n, int lower, int upper) 
     {
         return std::max(lower, std::min(n, upper));
     }
 
-    /// Preloads data for given quadkey.
-    void preload(const utymap::QuadKey& quadKey) const
+    /// Gets data for given quadkey loading it if necessary.
+    /// NOTE loaded grids are found without lock. Returned pointer keeps data
+    /// valid even if it is evicted from cache concurrently.
+    EleDataPtr getData(const utymap::QuadKey& quadKey) const
     {
-        std::lock_guard<std::mutex> lock(lock_);
-
-        if (data_.find(quadKey) != data_.end())
-            return;
+        return data_.get(quadKey, [&](const QuadKey& key) { return loadData(key); });
+    }
 
-        std::string filePath = getFilePath(quadKey);
-        std::fstream file(filePath);
-        if (!file.good())
-            throw std::invalid_argument(std::string("Cannot find elevation file:") + filePath);
+    /// Loads data from binary file converting text file if necessary. Should be called under lock.
+    EleDataPtr loadData(const utymap::QuadKey& quadKey) const
+    {
+        namespace fs = boost::filesystem;
 
-        EleData data;
+        std::string textPath = getFilePath(quadKey);
+        std::string binaryPath = getBinaryFilePath(quadKey);
+        BoundingBox bbox = utymap::utils::GeoUtils::quadKeyToBoundingBox(quadKey);
 
-        std::transform(std::istream_iterator<std::string>(file),
-                       std::istream_iterator<std::string>(),
-                       std::back_inserter(data.heights),
-                       [&](const std::string& heightString) {
-                           return utymap::utils::lexicalCast<int>(heightString);
-                       });
+        boost::system::error_code ec;
+        bool hasText = fs::exists(textPath, ec);
+        // NOTE without text file binary one is used as is.
+        std::string sourcePath = hasText ? textPath : "";
 
-        data.heights.shrink_to_fit();
+        auto data = std::make_shared<EleData>();
+        if ((fs::exists(binaryPath, ec) && tryMap(binaryPath, sourcePath, *data)) ||
+            (hasText && GridElevationConverter::convert(textPath, binaryPath, bbox) &&
+             tryMap(binaryPath, sourcePath, *data))) {
+            return data;
+        }
 
-        if (data.heights.empty())
-            throw std::domain_error("Cannot get elevation data from:" + filePath);
+        if (!hasText)
+            throw std::invalid_argument(std::string("Cannot find elevation file:") + textPath);
 
-        BoundingBox bbox = utymap::utils::GeoUtils::quadKeyToBoundingBox(quadKey);
+        // NOTE binary file cannot be written or read: use text data directly.
+        data->buffer = GridElevationConverter::parse(textPath);
+        data->heights = data->buffer.data();
+        setGeometry(*data, static_cast<int>(std::sqrt(data->buffer.size())) - 1,
+                    bbox.minPoint.latitude, bbox.minPoint.longitude,
+                    bbox.maxPoint.latitude, bbox.maxPoint.longitude);
+        return data;
+    }
 
-        data.resolution = static_cast<int>(std::sqrt(data.heights.size())) - 1;
-        data.xStart = static_cast<int>(bbox.minPoint.longitude * Scale);
-        data.yStart = static_cast<int>(bbox.minPoint.latitude * Scale);
-        data.xStep = static_cast<int>(bbox.width() / data.resolution * Scale);
-        data.yStep = static_cast<int>(bbox.height() / data.resolution * Scale);
+    /// Tries to map binary grid file into memory. Fails if text file path is not empty
+    /// and binary file is not converted from its current content.
+    bool tryMap(const std::string& binaryPath, const std::string& textPath, EleData& data) const
+    {
+        using namespace boost::interprocess;
+        try {
+            file_mapping file(binaryPath.c_str(), read_only);
+            mapped_region region(file, read_only);
+
+            GridElevationConverter::Header header;
+            if (region.get_size() < sizeof(header))
+                return false;
+            std::memcpy(&header, region.get_address(), sizeof(header));
+            if (!GridElevationConverter::isValid(header, region.get_size()) ||
+                (!textPath.empty() && !GridElevationConverter::isUpToDate(header, textPath, binaryPath)))
+                return false;
+
+            data.file = std::move(file);
+            data.region = std::move(region);
+            data.heights = reinterpret_cast<const std::int16_t*>(
+                static_cast<const char*>(data.region.get_address()) + sizeof(header));
+            setGeometry(data, header.resolution, header.minLatitude, header.minLongitude,
+                        header.maxLatitude, header.maxLongitude);
+            return true;
+        }
+        catch (const std::exception&) {
+            return false;
+        }
+    }
 
-        data_.emplace(quadKey, std::move(data));
+    /// Sets grid geometry in scaled integer coordinates.
+    void setGeometry(EleData& data, int resolution, double minLatitude, double minLongitude,
+                     double maxLatitude, double maxLongitude) const
+    {
+        data.resolution = resolution;
+        data.xStart = static_cast<int>(minLongitude * Scale);
+        data.yStart = static_cast<int>(minLatitude * Scale);
+        data.xStep = static_cast<int>((maxLongitude - minLongitude) / resolution * Scale);
+        data.yStep = static_cast<int>((maxLatitude - minLatitude) / resolution * Scale);
     }
 
     std::string getFilePath(const QuadKey& quadKey) const
@@ -140,8 +222,7 @@ private:
         return ss.str();
     }
 
-    mutable std::map<const QuadKey, EleData, QuadKey::Comparator> data_;
-    mutable std::mutex lock_;
+    mutable DataCache data_;
     const std::string dataDirectory_;
 };
 
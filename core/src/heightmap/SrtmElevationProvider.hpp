@@ -4,21 +4,25 @@
 #include "BoundingBox.hpp"
 #include "heightmap/ElevationProvider.hpp"
 #include "utils/GeoUtils.hpp"
+#include "utils/LruCache.hpp"
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <sstream>
 #include <string>
 #include <stdexcept>
-#include <map>
 #include <memory>
-#include <mutex>
 #include <iomanip>
-#include <vector>
 
 namespace utymap { namespace heightmap {
 
 /// Provides the way to get elevation for given location from SRTM data.
+/// Cells are memory mapped and kept in LRU cache of limited size.
 class SrtmElevationProvider final : public ElevationProvider
 {
     struct HgtCellKey
@@ -27,30 +31,41 @@ class SrtmElevationProvider final : public ElevationProvider
 
         HgtCellKey(int lat, int lon) : lat(lat), lon(lon) { }
 
-        bool operator<(const HgtCellKey& other) const 
-        { 
-            return lat < other.lat || (!(other.lat < lat) && lon < other.lon); 
+        bool operator==(const HgtCellKey& other) const
+        {
+            return lat == other.lat && lon == other.lon;
         }
     };
 
+    /// Memory mapped hgt file. Heights are big-endian int16 values read in place.
     struct HgtCell
     {
         int totalPx, secondsPerPx, offset;
-        std::vector<char> data;
-       
-        HgtCell(int totalPx, int secondsPerPx, std::vector<char>& data) :
+        boost::interprocess::file_mapping file;
+        boost::interprocess::mapped_region region;
+        const unsigned char* data;
+
+        HgtCell(int totalPx, int secondsPerPx,
+                boost::interprocess::file_mapping&& file,
+                boost::interprocess::mapped_region&& region) :
             totalPx(totalPx),
             secondsPerPx(secondsPerPx),
             offset((totalPx * totalPx - totalPx) * 2),
-            data(std::move(data))
+            file(std::move(file)),
+            region(std::move(region)),
+            data(static_cast<const unsigned char*>(this->region.get_address()))
         {
         }
     };
 
+    typedef utymap::utils::LruCache<HgtCellKey, HgtCell> Cells;
+    typedef Cells::ValuePtr HgtCellPtr;
+
 public:
 
     SrtmElevationProvider(std::string dataDirectory, int maxCacheSize = 4) :
-        dataDirectory_(dataDirectory), maxCacheSize_(maxCacheSize)
+        cells_(static_cast<std::size_t>(std::max(maxCacheSize, 1))),
+        dataDirectory_(dataDirectory)
     {
     }
 
@@ -64,38 +79,70 @@ public:
         return getElevationImpl(quadKey, latitude, longitude);
     }
 
-private:
+    /// Gets elevations for given geocoordinates resolving cell only when it differs from previous one.
+    void getElevations(const utymap::QuadKey& quadKey, const double* latitudes, const double* longitudes,
+                       double* elevations, std::size_t count) const override
+    {
+        std::size_t start = 0;
+        while (start < count) {
+            HgtCellKey hgtCellKey(static_cast<int>(latitudes[start]), static_cast<int>(longitudes[start]));
+            auto cell = getCell(quadKey, hgtCellKey);
+
+            std::size_t end = start + 1;
+            while (end < count &&
+                   static_cast<int>(latitudes[end]) == hgtCellKey.lat &&
+                   static_cast<int>(longitudes[end]) == hgtCellKey.lon)
+                ++end;
+
+            for (std::size_t i = start; i < end; ++i)
+                elevations[i] = interpolate(*cell, latitudes[i], longitudes[i]);
 
-    void preload(const utymap::QuadKey& quadKey, HgtCellKey& hgtCellKey) const
+            start = end;
+        }
+    }
+
+    /// Returns amount of currently loaded cells.
+    std::size_t getCacheSize() const
     {
-        std::lock_guard<std::mutex> lock(lock_);
+        return cells_.size();
+    }
 
-        if (cells_.find(hgtCellKey) != cells_.end())
-            return;
+private:
+
+    /// Gets cell for given key loading cells which cover quadkey if necessary.
+    /// NOTE resident cells are found without lock. Returned pointer keeps cell
+    /// mapped even if it is evicted from cache concurrently.
+    HgtCellPtr getCell(const utymap::QuadKey& quadKey, const HgtCellKey& hgtCellKey) const
+    {
+        return cells_.get(hgtCellKey,
+            [&](const HgtCellKey& key) { return readCell(getFilePath(key)); },
+            [&](const Cells::Loader& load) { preload(quadKey, load); });
+    }
 
+    /// Loads other cells which cover given quadkey while there is free space in cache.
+    static void preload(const utymap::QuadKey& quadKey, const Cells::Loader& load)
+    {
         BoundingBox bbox = utymap::utils::GeoUtils::quadKeyToBoundingBox(quadKey);
         int minLat = static_cast<int>(bbox.minPoint.latitude);
         int minLon = static_cast<int>(bbox.minPoint.longitude);
         int maxLat = static_cast<int>(bbox.maxPoint.latitude);
         int maxLon = static_cast<int>(bbox.maxPoint.longitude);
 
-        int latDiff = maxLat - minLat;
-        int lonDiff = maxLon - minLon;
-
-        for (int j = 0; j <= latDiff; j++)
-            for (int i = 0; i <= lonDiff; i++) {
-                HgtCellKey cellKey(minLat + j, minLon + i);
-
-                if (cells_.find(cellKey) != cells_.end())
-                    continue;
-
-                std::string path = getFilePath(cellKey);
-                HgtCell cell = readCell(path);
-                cells_.emplace(cellKey, readCell(path));
+        for (int lat = minLat; lat <= maxLat; ++lat)
+            for (int lon = minLon; lon <= maxLon; ++lon) {
+                if (!load(HgtCellKey(lat, lon)))
+                    return;
             }
     }
 
     double getElevationImpl(const utymap::QuadKey& quadKey, double latitude, double longitude) const
+    {
+        HgtCellKey hgtCellKey(static_cast<int>(latitude), static_cast<int>(longitude));
+        return interpolate(*getCell(quadKey, hgtCellKey), latitude, longitude);
+    }
+
+    /// Interpolates elevation for given geocoordinate which belongs to given cell.
+    static double interpolate(const HgtCell& cell, double latitude, double longitude)
     {
         int latDec = static_cast<int>(latitude);
         int lonDec = static_cast<int>(longitude);
@@ -103,15 +150,6 @@ private:
         double secondsLat = (latitude - latDec) * 3600;
         double secondsLon = (longitude - lonDec) * 3600;
 
-        HgtCellKey hgtCellKey(latDec, lonDec);
-        auto cellPtr = cells_.find(hgtCellKey);
-        if (cellPtr == cells_.end()) {
-            preload(quadKey, hgtCellKey);
-            cellPtr = cells_.find(hgtCellKey);
-        }
-
-        const auto& cell = cellPtr->second;
-
         // load tile
         //X corresponds to x/y values,
         //everything easter/norther (< S) is rounded to X.
@@ -152,17 +190,21 @@ private:
     static int readPx(const HgtCell& cell, int y, int x)
     {
         int pos = cell.offset + 2 * (x - cell.totalPx*y);
-        return (cell.data[pos]) << 8 | (cell.data[pos + 1]);
+        return static_cast<std::int16_t>(cell.data[pos] << 8 | cell.data[pos + 1]);
     }
 
-    static HgtCell readCell(const std::string& path)
+    static std::shared_ptr<HgtCell> readCell(const std::string& path)
     {
-        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary | std::ios::app);
-        file.seekg(0, std::ios::end);
-        auto size = file.tellg();
+        using namespace boost::interprocess;
+
+        if (!std::ifstream(path).good())
+            throw std::domain_error(std::string("Cannot load srtm file:") + path);
+
+        file_mapping file(path.c_str(), read_only);
+        mapped_region region(file, read_only);
 
         int totalPx, secondsPerPx;
-        switch (size) {
+        switch (region.get_size()) {
             case 1201 * 1201 * 2: // SRTM-3
                 totalPx = 1201;
                 secondsPerPx = 3;
@@ -172,16 +214,10 @@ private:
                 secondsPerPx = 1;
                 break;
             default:
-                file.close();
                 throw std::domain_error(std::string("Cannot load srtm file:") + path);
         }
 
-        file.seekg(0, std::ios::beg);
-
-        std::vector<char> data((std::istreambuf_iterator<char>(file)),
-                               (std::istreambuf_iterator<char>()));
-
-        return HgtCell(totalPx, secondsPerPx, data);
+        return std::make_shared<HgtCell>(totalPx, secondsPerPx, std::move(file), std::move(region));
     }
 
     std::string getFilePath(const HgtCellKey& key) const
@@ -197,10 +233,8 @@ private:
         return stream.str();
     }
 
-    mutable std::map<HgtCellKey, HgtCell> cells_;
-    mutable std::mutex lock_;
+    mutable Cells cells_;
     std::string dataDirectory_;
-    int maxCacheSize_;
 };
 
 }}
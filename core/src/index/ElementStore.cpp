@@ -8,51 +8,36 @@
 #include "formats/FormatTypes.hpp"
 #include "index/ElementGeometryClipper.hpp"
 #include "index/ElementStore.hpp"
+#include "utils/ElementUtils.hpp"
+#include "utils/ThreadPool.hpp"
 #include <mapcss/StyleConsts.hpp>
 
+#include <future>
+
 using namespace utymap;
 using namespace utymap::entities;
 using namespace utymap::formats;
 using namespace utymap::mapcss;
+using namespace utymap::utils;
 
 namespace {
     const std::string TrueValue = "true";
+    /// Min amount of tiles to clip when thread pool is used.
+    const std::size_t MinConcurrentTiles = 8;
 
-    /// Creates bounding box of given element.
-    class BoundingBoxVisitor : public ElementVisitor
-    {
-    public:
-        BoundingBox boundingBox;
-
-        void visitNode(const Node& node) override
-        {
-            boundingBox.expand(node.coordinate);
-        }
-
-        void visitWay(const Way& way) override
-        {
-            boundingBox.expand(way.coordinates.cbegin(), way.coordinates.cend());
-        }
-
-        void visitArea(const Area& area) override
-        {
-            boundingBox.expand(area.coordinates.cbegin(), area.coordinates.cend());
-        }
-
-        void visitRelation(const Relation& relation) override
-        {
-            for (const auto& element: relation.elements) {
-                element->accept(*this);
-            }
-        }
-    };
+    typedef std::vector<std::shared_ptr<Element>> Elements;
 }
 
 namespace utymap { namespace index {
 
-ElementStore::ElementStore(StringTable& stringTable) :
+ElementStore::ElementStore(StringTable& stringTable, std::size_t clipThreads) :
     clipKeyId_(stringTable.getId(StyleConsts::ClipKey())),
-    skipKeyId_(stringTable.getId(StyleConsts::SkipKey()))
+    skipKeyId_(stringTable.getId(StyleConsts::SkipKey())),
+    clipPool_(clipThreads > 1 ? utymap::utils::make_unique<utymap::utils::ThreadPool>(clipThreads) : nullptr)
+{
+}
+
+ElementStore::~ElementStore()
 {
 }
 
@@ -89,6 +74,8 @@ bool ElementStore::store(const Element& element, const LodRange& range, const St
     using namespace std::placeholders;
     ElementGeometryClipper geometryClipper(std::bind(&ElementStore::storeImpl, this, _1, _2));
     bool wasStored = false;
+    bool isIndexed = false;
+    std::vector<std::pair<QuadKey, BoundingBox>> clipTiles;
     for (int lod = range.start; lod <= range.end; ++lod) {
         Style style = styleProvider.forElement(element, lod);
         if (style.empty() || style.has(skipKeyId_, TrueValue))
@@ -103,17 +90,76 @@ bool ElementStore::store(const Element& element, const LodRange& range, const St
              if (!visitor(bboxVisitor.boundingBox, quadKeyBbox))
                  return;
 
-            if (style.has(clipKeyId_, TrueValue))
-                geometryClipper.clipAndCall(element, quadKey, quadKeyBbox);
+            if (!style.has(clipKeyId_, TrueValue)) {
+                if (isIndexed)
+                    storeImpl(element, quadKey);
+                else {
+                    storeIndexedImpl(element, quadKey, bboxVisitor.boundingBox);
+                    isIndexed = true;
+                }
+            }
+            else if (clipPool_ != nullptr)
+                clipTiles.push_back(std::make_pair(quadKey, quadKeyBbox));
             else
-                storeImpl(element, quadKey);
+                geometryClipper.clipAndCall(element, quadKey, quadKeyBbox);
 
             wasStored = true;
         });
+
+        if (clipTiles.size() >= MinConcurrentTiles)
+            clipConcurrently(element, clipTiles);
+        else {
+            for (const auto& tile : clipTiles)
+                geometryClipper.clipAndCall(element, tile.first, tile.second);
+        }
+        clipTiles.clear();
     }
 
+    if (wasStored && !isIndexed)
+        storeSpatialImpl(element, bboxVisitor.boundingBox);
+
     // NOTE still might be clipped and then skipped
     return wasStored;
 }
 
+void ElementStore::storeIndexedImpl(const Element& element, const QuadKey& quadKey, const BoundingBox& bbox)
+{
+    storeImpl(element, quadKey);
+    storeSpatialImpl(element, bbox);
+}
+
+void ElementStore::clipConcurrently(const Element& element, const std::vector<std::pair<QuadKey, BoundingBox>>& tiles)
+{
+    // NOTE every tile has own slot for results, so tasks do not share any mutable state.
+    std::vector<Elements> results(tiles.size());
+    std::size_t chunkCount = std::min(clipPool_->size(), tiles.size());
+    std::size_t chunkSize = (tiles.size() + chunkCount - 1) / chunkCount;
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(chunkCount);
+    for (std::size_t start = 0; start < tiles.size(); start += chunkSize) {
+        std::size_t end = std::min(start + chunkSize, tiles.size());
+        futures.push_back(clipPool_->enqueue([&, start, end]() {
+            std::size_t current = start;
+            ElementGeometryClipper geometryClipper([&](const Element& clipped, const QuadKey&) {
+                ElementCollector collector(results[current]);
+                clipped.accept(collector);
+            });
+            for (; current < end; ++current)
+                geometryClipper.clipAndCall(element, tiles[current].first, tiles[current].second);
+        }));
+    }
+
+    for (auto& future : futures)
+        future.wait();
+    for (auto& future : futures)
+        future.get();
+
+    // NOTE store implementation is called from this thread only and in the same order as in sequential case.
+    for (std::size_t i = 0; i < tiles.size(); ++i) {
+        for (const auto& clipped : results[i])
+            storeImpl(*clipped, tiles[i].first);
+    }
+}
+
 }}
@@ -2,26 +2,46 @@
 #define INDEX_ELEMENTSTORE_HPP_DEFINED
 
 #include "BoundingBox.hpp"
+#include "GeoCoordinate.hpp"
 #include "LodRange.hpp"
 #include "QuadKey.hpp"
 #include "entities/Element.hpp"
 #include "entities/ElementVisitor.hpp"
 #include "mapcss/StyleProvider.hpp"
 
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace utymap { namespace utils {
+class ThreadPool;
+}}
+
 namespace utymap { namespace index {
 
 /// Defines API to store elements.
 class ElementStore
 {
 public:
-    explicit ElementStore(utymap::index::StringTable& stringTable);
+    /// Creates element store. If clip threads is greater than one, geometry of
+    /// element which spans many tiles is clipped concurrently.
+    explicit ElementStore(utymap::index::StringTable& stringTable,
+                          std::size_t clipThreads = 0);
 
-    virtual ~ElementStore() = default;
+    virtual ~ElementStore();
 
-    /// Searches for elements for given quadKey
+    /// Searches for elements for given quadKey.
+    /// NOTE visitor receives elements which may be reused by store after visit call.
     virtual void search(const utymap::QuadKey& quadKey,
                         utymap::entities::ElementVisitor& visitor) = 0;
 
+    /// Searches for elements which bounding box is within radius (in meters) from given coordinate.
+    /// NOTE elements are returned with original (not clipped) geometry.
+    virtual void search(const utymap::GeoCoordinate& coordinate,
+                        double radius,
+                        utymap::entities::ElementVisitor& visitor) = 0;
+
     /// Checks whether there is data for given quadkey.
     virtual bool hasData(const utymap::QuadKey& quadKey) const = 0;
 
@@ -48,6 +68,16 @@ protected:
     /// Stores element in given quadkey.
     virtual void storeImpl(const utymap::entities::Element& element, const utymap::QuadKey& quadKey) = 0;
 
+    /// Stores element in given quadkey and adds stored copy with given bounding box to spatial index.
+    /// Called once instead of storeImpl for the first quadkey where element is stored without clipping.
+    virtual void storeIndexedImpl(const utymap::entities::Element& element,
+                                  const utymap::QuadKey& quadKey,
+                                  const utymap::BoundingBox& bbox);
+
+    /// Adds element with given bounding box to spatial index. Called once after all storeImpl
+    /// calls for element which is stored clipped in every quadkey.
+    virtual void storeSpatialImpl(const utymap::entities::Element& element, const utymap::BoundingBox& bbox) = 0;
+
 private:
     template <typename Visitor>
     bool store(const utymap::entities::Element& element,
@@ -55,7 +85,12 @@ private:
                const utymap::mapcss::StyleProvider& styleProvider,
                const Visitor& visitor);
 
+    /// Clips element for every tile using thread pool and stores results tile by tile.
+    void clipConcurrently(const utymap::entities::Element& element,
+                          const std::vector<std::pair<utymap::QuadKey, utymap::BoundingBox>>& tiles);
+
     const std::uint32_t clipKeyId_, skipKeyId_;
+    std::unique_ptr<utymap::utils::ThreadPool> clipPool_;
 };
 
 }}
@@ -1,4 +1,8 @@
 #include "entities/Element.hpp"
+#include "entities/Node.hpp"
+#include "entities/Way.hpp"
+#include "entities/Area.hpp"
+#include "entities/Relation.hpp"
 #include "LodRange.hpp"
 #include "formats/shape/ShapeDataVisitor.hpp"
 #include "formats/shape/ShapeParser.hpp"
@@ -9,24 +13,215 @@
 #include "index/GeoStore.hpp"
 #include "index/InMemoryElementStore.hpp"
 #include "utils/CoreUtils.hpp"
+#include "utils/ElementUtils.hpp"
+#include "utils/GeoUtils.hpp"
+#include "utils/ThreadPool.hpp"
 
-#include <set>
+#include <array>
+#include <future>
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <unordered_set>
 
+using namespace utymap;
 using namespace utymap::entities;
 using namespace utymap::formats;
 using namespace utymap::index;
 using namespace utymap::mapcss;
 
-class GeoStore::GeoStoreImpl final
-{
+namespace {
+    typedef std::vector<std::shared_ptr<Element>> Elements;
+
+    /// Estimates amount of memory used by element.
+    class ElementSizeVisitor : public ElementVisitor
+    {
+    public:
+        std::size_t size = 0;
+
+        void visitNode(const Node& node) override { size += sizeof(Node) + getSize(node.tags); }
+
+        void visitWay(const Way& way) override
+        {
+            size += sizeof(Way) + getSize(way.tags) + way.coordinates.size() * sizeof(GeoCoordinate);
+        }
+
+        void visitArea(const Area& area) override
+        {
+            size += sizeof(Area) + getSize(area.tags) + area.coordinates.size() * sizeof(GeoCoordinate);
+        }
+
+        void visitRelation(const Relation& relation) override
+        {
+            size += sizeof(Relation) + getSize(relation.tags);
+            for (const auto& element : relation.elements)
+                element->accept(*this);
+        }
+
+    private:
+        static std::size_t getSize(const std::vector<utymap::entities::Tag>& tags)
+        {
+            return tags.size() * sizeof(utymap::entities::Tag);
+        }
+    };
+
+    /// Keeps decoded elements of recently searched tiles within given memory budget (in bytes).
+    /// Least recently used tiles are evicted first. Access is synchronized.
+    class ElementCache final
+    {
+        typedef std::pair<std::string, QuadKey> Key;
+
+        struct KeyComparator
+        {
+            bool operator() (const Key& lhs, const Key& rhs) const
+            {
+                if (lhs.first == rhs.first)
+                    return QuadKey::Comparator()(lhs.second, rhs.second);
+                return lhs.first < rhs.first;
+            }
+        };
+
+        struct Entry
+        {
+            Key key;
+            std::shared_ptr<const Elements> elements;
+            std::size_t size;
+        };
+
+        typedef std::list<Entry> EntryList;
+        typedef std::map<Key, EntryList::iterator, KeyComparator> EntryMap;
+
+    public:
+        explicit ElementCache(std::size_t capacity) :
+            capacity_(capacity), size_(0), hits_(0), misses_(0), list_(), map_()
+        {
+        }
+
+        /// Returns cached elements of given tile or nullptr.
+        std::shared_ptr<const Elements> get(const std::string& storeKey, const QuadKey& quadKey)
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            auto it = map_.find(Key(storeKey, quadKey));
+            if (it == map_.end()) {
+                ++misses_;
+                return nullptr;
+            }
+
+            ++hits_;
+            list_.splice(list_.begin(), list_, it->second);
+            return it->second->elements;
+        }
+
+        /// Puts elements of given tile into cache evicting least recently used tiles if necessary.
+        void put(const std::string& storeKey, const QuadKey& quadKey, const std::shared_ptr<const Elements>& elements)
+        {
+            ElementSizeVisitor visitor;
+            for (const auto& element : *elements)
+                element->accept(visitor);
+            std::size_t size = sizeof(Entry) + visitor.size;
+
+            std::lock_guard<std::mutex> lock(lock_);
+            Key key(storeKey, quadKey);
+            auto it = map_.find(key);
+            if (it != map_.end())
+                erase(it);
+
+            if (size > capacity_)
+                return;
+
+            while (size_ + size > capacity_)
+                erase(map_.find(list_.back().key));
+
+            list_.push_front(Entry { key, elements, size });
+            map_[key] = list_.begin();
+            size_ += size;
+        }
+
+        /// Removes tiles of given store which satisfy predicate.
+        template <typename Predicate>
+        void invalidate(const std::string& storeKey, const Predicate& predicate)
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            for (auto it = map_.begin(); it != map_.end();) {
+                if (it->first.first == storeKey && predicate(it->first.second))
+                    erase(it++);
+                else
+                    ++it;
+            }
+        }
+
+        GeoStore::CacheStatistics getStatistics() const
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            return GeoStore::CacheStatistics { hits_, misses_, map_.size(), size_ };
+        }
+
+    private:
+        void erase(EntryMap::iterator it)
+        {
+            size_ -= it->second->size;
+            list_.erase(it->second);
+            map_.erase(it);
+        }
+
+        const std::size_t capacity_;
+        std::size_t size_;
+        std::uint64_t hits_;
+        std::uint64_t misses_;
+        EntryList list_;
+        EntryMap map_;
+        mutable std::mutex lock_;
+    };
+
+    /// Keeps ids of visited elements for single thread search.
+    class IdSet final
+    {
+    public:
+        /// Inserts id and returns true if it was not present.
+        bool insert(std::uint64_t id) { return ids_.insert(id).second; }
+
+    private:
+        std::unordered_set<std::uint64_t> ids_;
+    };
+
+    /// Keeps ids of visited elements split into shards with own locks to reduce contention.
+    class ShardedIdSet final
+    {
+        struct Shard
+        {
+            std::mutex lock;
+            std::unordered_set<std::uint64_t> ids;
+        };
+
+    public:
+        /// Inserts id and returns true if it was not present.
+        bool insert(std::uint64_t id)
+        {
+            auto& shard = shards_[id % shards_.size()];
+            std::lock_guard<std::mutex> lock(shard.lock);
+            return shard.ids.insert(id).second;
+        }
+
+    private:
+        std::array<Shard, 16> shards_;
+    };
+
+    /// Does not synchronize access to visitor.
+    struct NoLock final
+    {
+        void lock() { }
+        void unlock() { }
+    };
+
     /// Prevents to visit element twice if it exists in multiply stores.
+    template <typename Ids, typename Lock>
     class FilterElementVisitor : public ElementVisitor
     {
     public:
-        FilterElementVisitor(const QuadKey& quadKey, const StyleProvider& styleProvider, ElementVisitor& visitor)
-                : quadKey_(quadKey), styleProvider_(styleProvider), visitor_(visitor), ids_()
+        FilterElementVisitor(const LodRange& range, const StyleProvider& styleProvider,
+                             ElementVisitor& visitor, Ids& ids, Lock& lock)
+                : range_(range), styleProvider_(styleProvider), visitor_(visitor), ids_(ids), lock_(lock)
         {
         }
 
@@ -42,24 +237,38 @@ class GeoStore::GeoStoreImpl final
 
         void visitIfNecessary(const Element& element)
         {
-            if (element.id == 0 || ids_.find(element.id) == ids_.end() ||
-                    styleProvider_.hasStyle(element, quadKey_.levelOfDetail)) {
+            if (element.id == 0 || ids_.insert(element.id) || hasStyle(element)) {
+                std::lock_guard<Lock> lock(lock_);
                 element.accept(visitor_);
-                ids_.insert(element.id);
             }
         }
 
-        const QuadKey& quadKey_;
+        /// Checks whether element has style at any level of detail from range.
+        bool hasStyle(const Element& element) const
+        {
+            for (int lod = range_.start; lod <= range_.end; ++lod) {
+                if (styleProvider_.hasStyle(element, lod))
+                    return true;
+            }
+            return false;
+        }
+
+        const LodRange range_;
         const StyleProvider& styleProvider_;
         ElementVisitor& visitor_;
-
-        std::set<std::uint64_t> ids_;
+        Ids& ids_;
+        Lock& lock_;
     };
+}
 
+class GeoStore::GeoStoreImpl final
+{
 public:
 
-    explicit GeoStoreImpl(const StringTable& stringTable) :
-        stringTable_(stringTable)
+    GeoStoreImpl(const StringTable& stringTable, std::size_t searchThreads, std::size_t cacheSize) :
+        stringTable_(stringTable),
+        searchPool_(searchThreads > 1 ? utymap::utils::make_unique<utymap::utils::ThreadPool>(searchThreads) : nullptr),
+        cache_(cacheSize > 0 ? utymap::utils::make_unique<ElementCache>(cacheSize) : nullptr)
     {
     }
 
@@ -73,6 +282,7 @@ public:
         auto& elementStore = storeMap_[storeKey];
         elementStore->store(element, range, styleProvider);
         elementStore->commit();
+        invalidate(storeKey, range);
     }
 
     void add(const std::string& storeKey, const std::string& path, const QuadKey& quadKey, const StyleProvider& styleProvider)
@@ -82,6 +292,10 @@ public:
             return elementStore->store(element, quadKey, styleProvider);
         });
         elementStore->commit();
+        invalidate(storeKey, [&](const QuadKey& cached) {
+            return cached.levelOfDetail == quadKey.levelOfDetail &&
+                   cached.tileX == quadKey.tileX && cached.tileY == quadKey.tileY;
+        });
     }
 
     void add(const std::string& storeKey, const std::string& path, const LodRange& range, const StyleProvider& styleProvider)
@@ -91,6 +305,7 @@ public:
             return elementStore->store(element, range, styleProvider);
         });
         elementStore->commit();
+        invalidate(storeKey, range);
     }
 
     void add(const std::string& storeKey, const std::string& path, const BoundingBox& bbox, const LodRange& range, const StyleProvider& styleProvider)
@@ -100,6 +315,10 @@ public:
             return elementStore->store(element, bbox, range, styleProvider);
         });
         elementStore->commit();
+        invalidate(storeKey, [&](const QuadKey& cached) {
+            return cached.levelOfDetail >= range.start && cached.levelOfDetail <= range.end &&
+                   utymap::utils::GeoUtils::quadKeyToBoundingBox(cached).intersects(bbox);
+        });
     }
 
     void add(const std::string& path, const StyleProvider& styleProvider, const std::function<bool(Element&)>& functor) const
@@ -143,17 +362,29 @@ public:
 
     void search(const QuadKey& quadKey, const utymap::mapcss::StyleProvider& styleProvider, ElementVisitor& visitor)
     {
-        FilterElementVisitor filter(quadKey, styleProvider, visitor);
-        for (const auto& pair : storeMap_) {
-            // Search only if store has data
-            if (pair.second->hasData(quadKey))
-                pair.second->search(quadKey, filter);
+        if (searchPool_ != nullptr && storeMap_.size() > 1) {
+            searchConcurrently(quadKey, styleProvider, visitor);
+            return;
         }
+
+        IdSet ids;
+        NoLock lock;
+        FilterElementVisitor<IdSet, NoLock> filter(LodRange(quadKey.levelOfDetail, quadKey.levelOfDetail),
+                                                   styleProvider, visitor, ids, lock);
+        for (const auto& pair : storeMap_)
+            searchStore(pair.first, *pair.second, quadKey, filter);
     }
 
     void search(const GeoCoordinate& coordinate, double radius, const StyleProvider& styleProvider, ElementVisitor& visitor) const
     {
-        throw std::domain_error("Not implemented");
+        IdSet ids;
+        NoLock lock;
+        // NOTE radius search is not bound to level of detail.
+        FilterElementVisitor<IdSet, NoLock> filter(LodRange(utymap::utils::GeoUtils::MinLevelOfDetails,
+                                                            utymap::utils::GeoUtils::MaxLevelOfDetails),
+                                                   styleProvider, visitor, ids, lock);
+        for (const auto& pair : storeMap_)
+            pair.second->search(coordinate, radius, filter);
     }
 
     bool hasData(const QuadKey& quadKey)
@@ -165,9 +396,83 @@ public:
         return false;
     }
 
+    GeoStore::CacheStatistics getCacheStatistics() const
+    {
+        return cache_ != nullptr ? cache_->getStatistics() : GeoStore::CacheStatistics { 0, 0, 0, 0 };
+    }
+
 private:
+    /// Searches for elements of given store using cache if it is enabled.
+    void searchStore(const std::string& storeKey, ElementStore& elementStore, const QuadKey& quadKey, ElementVisitor& visitor)
+    {
+        if (cache_ == nullptr) {
+            // Search only if store has data
+            if (elementStore.hasData(quadKey))
+                elementStore.search(quadKey, visitor);
+            return;
+        }
+
+        auto elements = cache_->get(storeKey, quadKey);
+        if (elements == nullptr) {
+            // NOTE empty result is cached too.
+            auto loaded = std::make_shared<Elements>();
+            if (elementStore.hasData(quadKey)) {
+                utymap::utils::ElementCollector collector(*loaded);
+                elementStore.search(quadKey, collector);
+            }
+            cache_->put(storeKey, quadKey, loaded);
+            elements = loaded;
+        }
+
+        for (const auto& element : *elements)
+            element->accept(visitor);
+    }
+
+    /// Removes cached tiles of given store which are inside level of detail range.
+    void invalidate(const std::string& storeKey, const LodRange& range)
+    {
+        invalidate(storeKey, [&](const QuadKey& cached) {
+            return cached.levelOfDetail >= range.start && cached.levelOfDetail <= range.end;
+        });
+    }
+
+    template <typename Predicate>
+    void invalidate(const std::string& storeKey, const Predicate& predicate)
+    {
+        if (cache_ != nullptr)
+            cache_->invalidate(storeKey, predicate);
+    }
+
+    /// Reads every store in its own task. Elements are decoded concurrently,
+    /// but passed to visitor one by one as visitor is not thread safe.
+    void searchConcurrently(const QuadKey& quadKey, const StyleProvider& styleProvider, ElementVisitor& visitor)
+    {
+        ShardedIdSet ids;
+        std::mutex lock;
+        std::vector<std::future<void>> results;
+        results.reserve(storeMap_.size());
+
+        for (const auto& pair : storeMap_) {
+            const std::string& storeKey = pair.first;
+            ElementStore& elementStore = *pair.second;
+            results.push_back(searchPool_->enqueue([&, quadKey]() {
+                FilterElementVisitor<ShardedIdSet, std::mutex> filter(LodRange(quadKey.levelOfDetail, quadKey.levelOfDetail),
+                                                                      styleProvider, visitor, ids, lock);
+                searchStore(storeKey, elementStore, quadKey, filter);
+            }));
+        }
+
+        // NOTE wait for all tasks before rethrowing exception as they use local state.
+        for (auto& result : results)
+            result.wait();
+        for (auto& result : results)
+            result.get();
+    }
+
     const StringTable& stringTable_;
     std::map<std::string, std::unique_ptr<ElementStore>> storeMap_;
+    std::unique_ptr<utymap::utils::ThreadPool> searchPool_;
+    std::unique_ptr<ElementCache> cache_;
 
     static FormatType getFormatTypeFromPath(const std::string& path)
     {
@@ -182,7 +487,8 @@ private:
     }
 };
 
-GeoStore::GeoStore(const StringTable& stringTable) : pimpl_(utymap::utils::make_unique<GeoStoreImpl>(stringTable))
+GeoStore::GeoStore(const StringTable& stringTable, std::size_t searchThreads, std::size_t cacheSize) :
+    pimpl_(utymap::utils::make_unique<GeoStoreImpl>(stringTable, searchThreads, cacheSize))
 {
 }
 
@@ -231,3 +537,8 @@ bool utymap::index::GeoStore::hasData(const QuadKey& quadKey) const
 {
     return pimpl_->hasData(quadKey);
 }
+
+GeoStore::CacheStatistics utymap::index::GeoStore::getCacheStatistics() const
+{
+    return pimpl_->getCacheStatistics();
+}
@@ -11,6 +11,8 @@
 #include "index/StringTable.hpp"
 #include "mapcss/StyleProvider.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 
 namespace utymap { namespace index {
@@ -19,7 +21,24 @@ namespace utymap { namespace index {
 class GeoStore final
 {
 public:
-    explicit GeoStore(const utymap::index::StringTable& stringTable);
+    /// Represents state of cache of decoded tile elements.
+    struct CacheStatistics
+    {
+        std::uint64_t hits;
+        std::uint64_t misses;
+        /// Amount of cached tiles.
+        std::size_t entries;
+        /// Estimated memory used by cached elements in bytes.
+        std::size_t size;
+    };
+
+    /// Creates geo store. If search threads is greater than one, registered
+    /// stores are searched concurrently using thread pool of given size.
+    /// If cache size (in bytes) is not zero, decoded elements of recently
+    /// searched tiles are kept in memory per store.
+    explicit GeoStore(const utymap::index::StringTable& stringTable,
+                      std::size_t searchThreads = 0,
+                      std::size_t cacheSize = 0);
 
     ~GeoStore();
 
@@ -57,7 +76,9 @@ public:
                 const utymap::mapcss::StyleProvider& styleProvider,
                 utymap::entities::ElementVisitor& visitor);
 
-    /// Searches for elements inside circle with given parameters.
+    /// Searches for elements inside circle with given center and radius in meters.
+    /// Elements from several stores are filtered as in quadkey search, style
+    /// is checked at all levels of detail.
     void search(const GeoCoordinate& coordinate,
                 double radius,
                 const utymap::mapcss::StyleProvider& styleProvider,
@@ -66,6 +87,9 @@ public:
     /// Checks whether there is data for given quadkey.
     bool hasData(const QuadKey& quadKey) const;
 
+    /// Returns statistics of decoded tile elements cache.
+    CacheStatistics getCacheStatistics() const;
+
 private:
     class GeoStoreImpl;
     std::unique_ptr<GeoStoreImpl> pimpl_;
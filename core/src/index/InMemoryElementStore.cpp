@@ -3,6 +3,8 @@
 #include "entities/Area.hpp"
 #include "entities/Relation.hpp"
 #include "index/InMemoryElementStore.hpp"
+#include "index/SpatialIndex.hpp"
+#include "utils/ElementUtils.hpp"
 
 #include <map>
 
@@ -10,48 +12,18 @@ using namespace utymap;
 using namespace utymap::index;
 using namespace utymap::entities;
 using namespace utymap::mapcss;
+using namespace utymap::utils;
 
 namespace {
     typedef std::vector<std::shared_ptr<Element>> Elements;
     typedef std::map<QuadKey, Elements, QuadKey::Comparator> ElementMap;
-
-    class ElementMapVisitor : public ElementVisitor
-    {
-    public:
-        ElementMapVisitor(const QuadKey& quadKey, ElementMap& elementsMap) :
-            quadKey_(quadKey), elementsMap_(elementsMap)
-        {
-        }
-
-        void visitNode(const utymap::entities::Node& node) override
-        {
-            elementsMap_[quadKey_].push_back(std::make_shared<Node>(node));
-        }
-
-        void visitWay(const utymap::entities::Way& way) override
-        {
-            elementsMap_[quadKey_].push_back(std::make_shared<Way>(way));
-        }
-
-        void visitArea(const utymap::entities::Area& area) override
-        {
-            elementsMap_[quadKey_].push_back(std::make_shared<Area>(area));
-        }
-
-        void visitRelation(const utymap::entities::Relation& relation) override
-        {
-            elementsMap_[quadKey_].push_back(std::make_shared<Relation>(relation));
-        }
-    private:
-        const QuadKey& quadKey_;
-        ElementMap& elementsMap_;
-    };
 }
 
 class InMemoryElementStore::InMemoryElementStoreImpl
 {
  public:
     ElementMap elementsMap;
+    SpatialIndex<std::shared_ptr<Element>> spatialIndex;
 
     ElementMap::const_iterator begin(const utymap::QuadKey& quadKey) const
     {
@@ -69,8 +41,8 @@ class InMemoryElementStore::InMemoryElementStoreImpl
     }  
 };
 
-InMemoryElementStore::InMemoryElementStore(StringTable& stringTable) :
-    ElementStore(stringTable), pimpl_(utymap::utils::make_unique<InMemoryElementStoreImpl>())
+InMemoryElementStore::InMemoryElementStore(StringTable& stringTable, std::size_t clipThreads) :
+    ElementStore(stringTable, clipThreads), pimpl_(utymap::utils::make_unique<InMemoryElementStoreImpl>())
 {
 }
 
@@ -80,8 +52,25 @@ InMemoryElementStore::~InMemoryElementStore()
 
 void InMemoryElementStore::storeImpl(const utymap::entities::Element& element, const QuadKey& quadKey)
 {
-    ElementMapVisitor visitor(quadKey, pimpl_->elementsMap);
+    ElementCollector visitor(pimpl_->elementsMap[quadKey]);
+    element.accept(visitor);
+}
+
+void InMemoryElementStore::storeIndexedImpl(const utymap::entities::Element& element, const QuadKey& quadKey, const BoundingBox& bbox)
+{
+    // NOTE element is stored as is, so its copy is shared with spatial index.
+    auto& elements = pimpl_->elementsMap[quadKey];
+    ElementCollector visitor(elements);
+    element.accept(visitor);
+    pimpl_->spatialIndex.insert(bbox, elements.back());
+}
+
+void InMemoryElementStore::storeSpatialImpl(const utymap::entities::Element& element, const BoundingBox& bbox)
+{
+    Elements elements;
+    ElementCollector visitor(elements);
     element.accept(visitor);
+    pimpl_->spatialIndex.insert(bbox, elements.front());
 }
 
 bool InMemoryElementStore::hasData(const utymap::QuadKey& quadKey) const
@@ -102,6 +91,13 @@ void InMemoryElementStore::search(const utymap::QuadKey& quadKey, utymap::entiti
     }
 }
 
+void InMemoryElementStore::search(const GeoCoordinate& coordinate, double radius, ElementVisitor& visitor)
+{
+    pimpl_->spatialIndex.search(coordinate, radius, [&](const std::shared_ptr<Element>& element) {
+        element->accept(visitor);
+    });
+}
+
 void InMemoryElementStore::commit()
 {
 
@@ -14,13 +14,18 @@ namespace utymap { namespace index {
 class InMemoryElementStore final : public ElementStore
 {
 public:
-    explicit InMemoryElementStore(utymap::index::StringTable& stringTable);
+    explicit InMemoryElementStore(utymap::index::StringTable& stringTable,
+                                  std::size_t clipThreads = 0);
 
     virtual ~InMemoryElementStore();
 
     void search(const utymap::QuadKey& quadKey, 
                 utymap::entities::ElementVisitor& visitor) override;
 
+    void search(const utymap::GeoCoordinate& coordinate,
+                double radius,
+                utymap::entities::ElementVisitor& visitor) override;
+
     bool hasData(const utymap::QuadKey& quadKey) const override;
 
     void commit() override;
@@ -28,6 +33,12 @@ public:
 protected:
     void storeImpl(const utymap::entities::Element& element, const utymap::QuadKey& quadKey) override;
 
+    void storeIndexedImpl(const utymap::entities::Element& element,
+                          const utymap::QuadKey& quadKey,
+                          const utymap::BoundingBox& bbox) override;
+
+    void storeSpatialImpl(const utymap::entities::Element& element, const utymap::BoundingBox& bbox) override;
+
 private:
     class InMemoryElementStoreImpl;
     std::unique_ptr<InMemoryElementStoreImpl> pimpl_;
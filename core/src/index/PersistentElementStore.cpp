@@ -4,10 +4,25 @@
 #include "entities/Area.hpp"
 #include "entities/Relation.hpp"
 #include "index/PersistentElementStore.hpp"
+#include "index/SpatialIndex.hpp"
 #include "utils/CoreUtils.hpp"
+#include "utils/ElementUtils.hpp"
 
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <fstream>
+#include <limits>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
 #include <sstream>
+#include <stdexcept>
 
 using namespace utymap;
 using namespace utymap::index;
@@ -22,30 +37,265 @@ namespace {
     ///     Element      |  List of entries, each is represented by element id (8b) and file offset (4b)     |
     ///------------------------------------------------------------------------------------------------------|
     const std::string IndexFileExtension = ".idf";
+    const std::size_t IndexEntrySize = sizeof(std::uint64_t) + sizeof(std::uint32_t);
 
     ///                                      Data file format
     ///------------------------------------------------------------------------------------------------------|
     ///   DESCRIPTION    |                       DETAILS                                                     |
     ///------------------------------------------------------------------------------------------------------|
+    ///  (4b) Header     |  'U' 'T' 'Y' followed by format version. Missing in version 1 files.              |
+    ///------------------------------------------------------------------------------------------------------|
+    ///                  |             List of elements, each is stored as:                                  |
+    ///------------------------------------------------------------------------------------------------------|
     ///  (1b) Flags      |  00 00 00 AA, where:                                                              |
     ///                  |    AA - Element type (00 - Node, 01 - Way, 10 - Area, 11 - Relation)              |
     ///------------------------------------------------------------------------------------------------------|
-    ///  (2b) Tags Size  |  Size of tag list where each tag represented by key-value pair (4b + 4b)          |
+    ///   Tags Size      |  Size of tag list where each tag represented by key-value pair of string ids     |
     ///------------------------------------------------------------------------------------------------------|
-    ///      Tags        |               Tags data with size (2b)                                            |
+    ///      Tags        |               Tags data                                                           |
     ///------------------------------------------------------------------------------------------------------|
     ///    Geometry      |             Geometry for Node, Way or Area                                        |
     ///       or         |                                                                                   |
     ///    Element List  |             Element list in the same format + id                                  |
     ///                  |                                                                                   |
     ///------------------------------------------------------------------------------------------------------|
+    ///   Version 1      |  sizes are 2b, string ids are 4b, element ids are 8b, coordinates are            |
+    ///                  |  latitude/longitude pairs of raw doubles (8b + 8b).                               |
+    ///------------------------------------------------------------------------------------------------------|
+    ///   Version 2      |  sizes and ids are varints, coordinates are fixed point integers (1E7) encoded as |
+    ///                  |  zig-zag varints; each coordinate of Way or Area is a delta to the previous one.  |
+    ///------------------------------------------------------------------------------------------------------|
     const std::string DataFileExtension = ".dat";
+    const std::size_t DataHeaderSize = 4;
+    const char DataHeaderMagic[] = { 'U', 'T', 'Y' };
+    const std::uint8_t CurrentDataVersion = 2;
+
+    ///                                      Manifest file format
+    ///------------------------------------------------------------------------------------------------------|
+    ///   DESCRIPTION    |                       DETAILS                                                     |
+    ///------------------------------------------------------------------------------------------------------|
+    ///     QuadKeys     |  List of quadkeys which have data files: level of detail, tile x, tile y (4b each)|
+    ///------------------------------------------------------------------------------------------------------|
+    const std::string ManifestFileName = "manifest.idx";
+
+    ///                                      Spatial files
+    ///------------------------------------------------------------------------------------------------------|
+    ///   DESCRIPTION    |                       DETAILS                                                     |
+    ///------------------------------------------------------------------------------------------------------|
+    ///   Spatial data   |  Original geometry of elements which are stored clipped, in data file format.   |
+    ///------------------------------------------------------------------------------------------------------|
+    ///  (4b) Header     |  'U' 'T' 'S' followed by spatial index version.                                   |
+    ///------------------------------------------------------------------------------------------------------|
+    ///   Spatial index  |  List of entries: bounding box (4 x 8b), element id (8b), quadkey (3 x 4b) and    |
+    ///                  |  data offset (8b). Offset points to quadkey data file or to spatial data file if  |
+    ///                  |  level of detail is zero.                                                         |
+    ///------------------------------------------------------------------------------------------------------|
+    const std::string SpatialIndexFileName = "spatial.idf";
+    const std::string SpatialDataFileName = "spatial.dat";
+    const char SpatialHeaderMagic[] = { 'U', 'T', 'S' };
+    const std::uint8_t SpatialIndexVersion = 2;
+    const std::size_t SpatialEntrySize = 4 * sizeof(double) + sizeof(std::uint64_t) +
+                                         3 * sizeof(std::int32_t) + sizeof(std::uint64_t);
+
+    /// Index entries: element id and data offset.
+    typedef std::vector<std::pair<std::uint64_t, std::uint64_t>> IndexEntries;
+
+    /// Specifies where element is stored in data files.
+    struct ElementLocation final
+    {
+        std::uint64_t id;
+        /// Quadkey of data file or quadkey with zero level of detail for spatial data file.
+        QuadKey quadKey;
+        std::uint64_t offset;
+    };
+
+    typedef std::vector<std::pair<BoundingBox, ElementLocation>> SpatialEntries;
+
+    /// Precision of fixed point coordinates: the same as used by clipper.
+    const double CoordinatePrecision = 1E7;
+
+    /// Appends raw value to buffer.
+    template <typename T>
+    void append(std::vector<char>& buffer, const T& value)
+    {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(value));
+    }
+
+    /// Stores values as fixed size raw values (version 1).
+    struct RawFormat final
+    {
+        static void writeSize(std::vector<char>& buffer, std::size_t size)
+        {
+            append(buffer, static_cast<std::uint16_t>(size));
+        }
+
+        static void writeStringId(std::vector<char>& buffer, std::uint32_t id) { append(buffer, id); }
+
+        static void writeElementId(std::vector<char>& buffer, std::uint64_t id) { append(buffer, id); }
+
+        static void writeCoordinate(std::vector<char>& buffer, const GeoCoordinate& coordinate)
+        {
+            append(buffer, coordinate.latitude);
+            append(buffer, coordinate.longitude);
+        }
+
+        static void writeCoordinates(std::vector<char>& buffer, const std::vector<GeoCoordinate>& coordinates)
+        {
+            writeSize(buffer, coordinates.size());
+            for (const auto& coordinate : coordinates)
+                writeCoordinate(buffer, coordinate);
+        }
+
+        template <typename Source>
+        static std::size_t readSize(Source& source) { return read<std::uint16_t>(source); }
+
+        template <typename Source>
+        static std::uint32_t readStringId(Source& source) { return read<std::uint32_t>(source); }
+
+        template <typename Source>
+        static std::uint64_t readElementId(Source& source) { return read<std::uint64_t>(source); }
+
+        template <typename Source>
+        static GeoCoordinate readCoordinate(Source& source)
+        {
+            GeoCoordinate coordinate;
+            source.read(coordinate.latitude);
+            source.read(coordinate.longitude);
+            return coordinate;
+        }
+
+        template <typename Source>
+        static void readCoordinates(Source& source, std::vector<GeoCoordinate>& coordinates)
+        {
+            std::size_t size = readSize(source);
+            coordinates.reserve(size);
+            for (std::size_t i = 0; i < size; ++i)
+                coordinates.push_back(readCoordinate(source));
+        }
+
+    private:
+        template <typename T, typename Source>
+        static T read(Source& source)
+        {
+            T value;
+            source.read(value);
+            return value;
+        }
+    };
+
+    /// Stores values as varints and coordinates as zig-zag encoded fixed point deltas (version 2).
+    struct CompactFormat final
+    {
+        static void writeSize(std::vector<char>& buffer, std::size_t size) { writeVarint(buffer, size); }
+
+        static void writeStringId(std::vector<char>& buffer, std::uint32_t id) { writeVarint(buffer, id); }
+
+        static void writeElementId(std::vector<char>& buffer, std::uint64_t id) { writeVarint(buffer, id); }
+
+        static void writeCoordinate(std::vector<char>& buffer, const GeoCoordinate& coordinate)
+        {
+            writeSignedVarint(buffer, toFixed(coordinate.latitude));
+            writeSignedVarint(buffer, toFixed(coordinate.longitude));
+        }
+
+        static void writeCoordinates(std::vector<char>& buffer, const std::vector<GeoCoordinate>& coordinates)
+        {
+            writeSize(buffer, coordinates.size());
+            std::int64_t lastLatitude = 0, lastLongitude = 0;
+            for (const auto& coordinate : coordinates) {
+                std::int64_t latitude = toFixed(coordinate.latitude);
+                std::int64_t longitude = toFixed(coordinate.longitude);
+                writeSignedVarint(buffer, latitude - lastLatitude);
+                writeSignedVarint(buffer, longitude - lastLongitude);
+                lastLatitude = latitude;
+                lastLongitude = longitude;
+            }
+        }
+
+        template <typename Source>
+        static std::size_t readSize(Source& source) { return static_cast<std::size_t>(readVarint(source)); }
+
+        template <typename Source>
+        static std::uint32_t readStringId(Source& source) { return static_cast<std::uint32_t>(readVarint(source)); }
+
+        template <typename Source>
+        static std::uint64_t readElementId(Source& source) { return readVarint(source); }
+
+        template <typename Source>
+        static GeoCoordinate readCoordinate(Source& source)
+        {
+            double latitude = fromFixed(readSignedVarint(source));
+            double longitude = fromFixed(readSignedVarint(source));
+            return GeoCoordinate(latitude, longitude);
+        }
+
+        template <typename Source>
+        static void readCoordinates(Source& source, std::vector<GeoCoordinate>& coordinates)
+        {
+            std::size_t size = readSize(source);
+            coordinates.reserve(size);
+            std::int64_t latitude = 0, longitude = 0;
+            for (std::size_t i = 0; i < size; ++i) {
+                latitude += readSignedVarint(source);
+                longitude += readSignedVarint(source);
+                coordinates.push_back(GeoCoordinate(fromFixed(latitude), fromFixed(longitude)));
+            }
+        }
+
+    private:
+        static std::int64_t toFixed(double value)
+        {
+            return static_cast<std::int64_t>(std::round(value * CoordinatePrecision));
+        }
+
+        static double fromFixed(std::int64_t value)
+        {
+            return value / CoordinatePrecision;
+        }
+
+        static void writeVarint(std::vector<char>& buffer, std::uint64_t value)
+        {
+            while (value >= 0x80) {
+                buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+            buffer.push_back(static_cast<char>(value));
+        }
+
+        static void writeSignedVarint(std::vector<char>& buffer, std::int64_t value)
+        {
+            writeVarint(buffer, (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+        }
+
+        template <typename Source>
+        static std::uint64_t readVarint(Source& source)
+        {
+            std::uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                std::uint8_t byte;
+                source.read(byte);
+                value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0)
+                    return value;
+            }
+            throw std::domain_error("Malformed varint in data file.");
+        }
+
+        template <typename Source>
+        static std::int64_t readSignedVarint(Source& source)
+        {
+            std::uint64_t value = readVarint(source);
+            return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+        }
+    };
 
-    /// Writes element to file stream.
+    /// Writes element to memory buffer using given format.
+    template <typename Format>
     class ElementWriter final : public ElementVisitor
     {
     public:
-        explicit ElementWriter(std::fstream& dataFile) : dataFile_(dataFile)
+        explicit ElementWriter(std::vector<char>& buffer) : buffer_(buffer)
         {
         }
 
@@ -53,40 +303,30 @@ namespace {
         {
             writeFlags(0);
             writeTags(node.tags);
-            writeCoordinate(node.coordinate);
+            Format::writeCoordinate(buffer_, node.coordinate);
         }
 
         void visitWay(const Way& way) override
         {
             writeFlags(1);
             writeTags(way.tags);
-            std::uint16_t size = static_cast<std::uint16_t>(way.coordinates.size());
-            dataFile_.write(reinterpret_cast<const char*>(&size), sizeof(size));
-            for (const auto& coord : way.coordinates) {
-                writeCoordinate(coord);
-            }
+            Format::writeCoordinates(buffer_, way.coordinates);
         }
 
         void visitArea(const Area& area) override
         {
             writeFlags(2);
             writeTags(area.tags);
-            // NOTE do not write the last one
-            std::uint16_t size = static_cast<std::uint16_t>(area.coordinates.size());
-            dataFile_.write(reinterpret_cast<const char*>(&size), sizeof(size));
-            for (const auto& coord : area.coordinates) {
-                writeCoordinate(coord);
-            }
+            Format::writeCoordinates(buffer_, area.coordinates);
         }
 
         void visitRelation(const Relation& relation) override
         {
             writeFlags(3);
             writeTags(relation.tags);
-            std::uint16_t elementSize = static_cast<std::uint16_t>(relation.elements.size());
-            dataFile_.write(reinterpret_cast<const char*>(&elementSize), sizeof(elementSize));
+            Format::writeSize(buffer_, relation.elements.size());
             for (const auto& element : relation.elements) {
-                dataFile_.write(reinterpret_cast<const char*>(&element->id), sizeof(element->id));
+                Format::writeElementId(buffer_, element->id);
                 element->accept(*this);
             }
         }
@@ -95,243 +335,959 @@ namespace {
 
         void writeFlags(const std::uint8_t flags)
         {
-            dataFile_.write(reinterpret_cast<const char*>(&flags), sizeof(flags));
+            append(buffer_, flags);
         }
 
         void writeTags(const std::vector<Tag>& tags)
         {
-            std::uint16_t size = static_cast<std::uint16_t>(tags.size());
-            dataFile_.write(reinterpret_cast<const char*>(&size), sizeof(size));
+            Format::writeSize(buffer_, tags.size());
             for (const auto& tag : tags) {
-                dataFile_.write(reinterpret_cast<const char*>(&tag.key), sizeof(tag.key));
-                dataFile_.write(reinterpret_cast<const char*>(&tag.value), sizeof(tag.value));
+                Format::writeStringId(buffer_, tag.key);
+                Format::writeStringId(buffer_, tag.value);
             }
         }
 
-        void writeCoordinate(const GeoCoordinate& coord)
+        std::vector<char>& buffer_;
+    };
+
+    /// Keeps serialized elements of one quadkey till they are flushed to disk.
+    struct QuadKeyBuffer final
+    {
+        QuadKeyBuffer(std::uint8_t version, std::uint64_t fileOffset) :
+            version(version), fileOffset(fileOffset), data(), entries()
         {
-            dataFile_.write(reinterpret_cast<const char*>(&coord.latitude), sizeof(coord.latitude));
-            dataFile_.write(reinterpret_cast<const char*>(&coord.longitude), sizeof(coord.longitude));
         }
 
-        std::fstream& dataFile_;
+        /// Data format version of target file.
+        std::uint8_t version;
+        /// Offset in target file where data is written on flush.
+        std::uint64_t fileOffset;
+        /// Element data in data file format.
+        std::vector<char> data;
+        /// Index entries: element id and offset relative to data buffer.
+        IndexEntries entries;
     };
 
-    /// Reads element from file stream.
-    class ElementReader final
+    /// Represents index and data files opened for appending.
+    struct AppendFiles final
+    {
+        std::ofstream index;
+        std::ofstream data;
+    };
+
+    /// Keeps limited amount of opened files evicting least recently used ones.
+    class FileCache final
     {
+        typedef std::list<std::pair<QuadKey, std::unique_ptr<AppendFiles>>> FileList;
+        typedef std::map<QuadKey, FileList::iterator, QuadKey::Comparator> FileMap;
+
     public:
-        explicit ElementReader(std::fstream& dataFile) : dataFile_(dataFile)
+        explicit FileCache(std::size_t capacity) :
+            capacity_(std::max<std::size_t>(capacity, 1)), list_(), map_()
         {
         }
 
-        std::shared_ptr<Element> readElement(std::uint64_t id, std::uint32_t offset)
+        /// Returns files for given quadkey opening them if necessary.
+        AppendFiles& get(const QuadKey& quadKey, const std::string& indexPath, const std::string& dataPath)
         {
-            dataFile_.seekg(offset, std::ios::beg);
-            auto element = readElement();
-            element->id = id;
-            return element;
+            auto it = map_.find(quadKey);
+            if (it != map_.end()) {
+                list_.splice(list_.begin(), list_, it->second);
+                return *it->second->second;
+            }
+
+            if (map_.size() >= capacity_) {
+                map_.erase(list_.back().first);
+                list_.pop_back();
+            }
+
+            using std::ios;
+            auto files = utymap::utils::make_unique<AppendFiles>();
+            files->index.open(indexPath, ios::out | ios::binary | ios::app | ios::ate);
+            files->data.open(dataPath, ios::out | ios::binary | ios::app | ios::ate);
+
+            list_.emplace_front(quadKey, std::move(files));
+            map_[quadKey] = list_.begin();
+
+            return *list_.front().second;
+        }
+
+        /// Closes all files.
+        void clear()
+        {
+            map_.clear();
+            list_.clear();
         }
 
     private:
+        const std::size_t capacity_;
+        FileList list_;
+        FileMap map_;
+    };
 
-        std::shared_ptr<Element> readElement()
+    /// Reads raw values from file stream.
+    class StreamSource final
+    {
+    public:
+        explicit StreamSource(std::istream& file) : file_(file)
         {
-            std::uint8_t flags;
-            dataFile_.read(reinterpret_cast<char*>(&flags), sizeof(flags));
-            std::uint8_t elementType = flags & 0x3;
+        }
+
+        void seek(std::uint64_t offset)
+        {
+            file_.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+        }
+
+        template <typename T>
+        void read(T& value)
+        {
+            if (!file_.read(reinterpret_cast<char*>(&value), sizeof(value)))
+                throw std::out_of_range("Unexpected end of data file.");
+        }
+
+    private:
+        std::istream& file_;
+    };
+
+    /// Reads raw values directly from memory mapped file content.
+    class MappedSource final
+    {
+    public:
+        MappedSource(const char* data, std::size_t size) :
+            begin_(data), end_(data + size), current_(data)
+        {
+        }
+
+        void seek(std::uint64_t offset)
+        {
+            if (offset > static_cast<std::uint64_t>(end_ - begin_))
+                throw std::out_of_range("Offset is outside of mapped file.");
+
+            current_ = begin_ + offset;
+        }
 
-            switch (elementType) {
+        template <typename T>
+        void read(T& value)
+        {
+            if (static_cast<std::size_t>(end_ - current_) < sizeof(value))
+                throw std::out_of_range("Unexpected end of mapped file.");
+
+            // NOTE data is not aligned, so memcpy is used instead of cast.
+            std::memcpy(&value, current_, sizeof(value));
+            current_ += sizeof(value);
+        }
+
+    private:
+        const char* begin_;
+        const char* end_;
+        const char* current_;
+    };
+
+    /// Maps whole file into memory in read only mode.
+    class MappedFile final
+    {
+    public:
+        explicit MappedFile(const std::string& path) : region_()
+        {
+            namespace ipc = boost::interprocess;
+            try {
+                ipc::file_mapping mapping(path.c_str(), ipc::read_only);
+                region_ = ipc::mapped_region(mapping, ipc::read_only);
+            }
+            catch (const ipc::interprocess_exception&) {
+                // NOTE file does not exist or it is empty: nothing to map.
+            }
+        }
+
+        const char* data() const { return static_cast<const char*>(region_.get_address()); }
+
+        std::size_t size() const { return region_.get_size(); }
+
+    private:
+        boost::interprocess::mapped_region region_;
+    };
+
+    /// Reads element from given source using given format.
+    /// NOTE top level elements are decoded into instances owned by reader, so they
+    /// are valid only till next read. Relation members are always allocated.
+    template <typename Source, typename Format>
+    class ElementReader final
+    {
+    public:
+        explicit ElementReader(Source& source) : source_(source)
+        {
+        }
+
+        const Element& readElement(std::uint64_t id, std::uint64_t offset)
+        {
+            source_.seek(offset);
+
+            Element* element;
+            switch (readElementType()) {
             case 0:
-                return readNode();
+                element = &readNode(node_);
+                break;
             case 1:
-                return readWay();
+                element = &readWay(way_);
+                break;
             case 2:
-                return readArea();
+                element = &readArea(area_);
+                break;
             default:
-                return readRelation();
+                relation_.elements.clear();
+                element = &readRelation(relation_);
+                break;
             }
+
+            element->id = id;
+            return *element;
+        }
+
+    private:
+
+        std::uint8_t readElementType()
+        {
+            std::uint8_t flags;
+            source_.read(flags);
+            return flags & 0x3;
         }
 
-        std::shared_ptr<Node> readNode()
+        std::shared_ptr<Element> readOwnedElement()
         {
-            auto node = std::make_shared<Node>();
-            node->tags = readTags();
-            node->coordinate = readCoordinate();
+            switch (readElementType()) {
+            case 0: {
+                auto node = std::make_shared<Node>();
+                readNode(*node);
+                return node;
+            }
+            case 1: {
+                auto way = std::make_shared<Way>();
+                readWay(*way);
+                return way;
+            }
+            case 2: {
+                auto area = std::make_shared<Area>();
+                readArea(*area);
+                return area;
+            }
+            default: {
+                auto relation = std::make_shared<Relation>();
+                readRelation(*relation);
+                return relation;
+            }
+            }
+        }
+
+        Node& readNode(Node& node)
+        {
+            readTags(node.tags);
+            node.coordinate = Format::readCoordinate(source_);
             return node;
         }
 
-        std::shared_ptr<Way> readWay()
+        Way& readWay(Way& way)
         {
-            auto way = std::make_shared<Way>();
-            way->tags = readTags();
-            way->coordinates = readCoordinates();
+            readTags(way.tags);
+            way.coordinates.clear();
+            Format::readCoordinates(source_, way.coordinates);
             return way;
         }
 
-        std::shared_ptr<Area> readArea()
+        Area& readArea(Area& area)
         {
-            auto area = std::make_shared<Area>();
-            area->tags = readTags();
-            area->coordinates = readCoordinates();
+            readTags(area.tags);
+            area.coordinates.clear();
+            Format::readCoordinates(source_, area.coordinates);
             return area;
         }
 
-        std::shared_ptr<Relation> readRelation()
+        Relation& readRelation(Relation& relation)
         {
-            auto relation = std::make_shared<Relation>();
-            relation->tags = readTags();
-            std::uint16_t elementSize;
-            dataFile_.read(reinterpret_cast<char*>(&elementSize), sizeof(elementSize));
+            readTags(relation.tags);
+            std::size_t elementSize = Format::readSize(source_);
 
-            for (std::uint16_t i = 0; i < elementSize; ++i) {
-                std::uint64_t id;
-                dataFile_.read(reinterpret_cast<char*>(&id), sizeof(id));
-                auto element = readElement();
+            relation.elements.reserve(elementSize);
+            for (std::size_t i = 0; i < elementSize; ++i) {
+                std::uint64_t id = Format::readElementId(source_);
+                auto element = readOwnedElement();
                 element->id = id;
-                relation->elements.push_back(element);
+                relation.elements.push_back(element);
             }
             return relation;
         }
 
-        inline GeoCoordinate readCoordinate()
+        /// Reads tags reusing capacity of given vector.
+        void readTags(std::vector<Tag>& tags)
         {
-            GeoCoordinate coord;
-            dataFile_.read(reinterpret_cast<char*>(&coord.latitude), sizeof(coord.latitude));
-            dataFile_.read(reinterpret_cast<char*>(&coord.longitude), sizeof(coord.longitude));
-            return coord;
+            std::size_t tagSize = Format::readSize(source_);
+
+            tags.clear();
+            tags.reserve(tagSize);
+            for (std::size_t i = 0; i < tagSize; ++i) {
+                std::uint32_t key = Format::readStringId(source_);
+                std::uint32_t value = Format::readStringId(source_);
+                tags.push_back(Tag(key, value));
+            }
         }
 
-        inline std::vector<GeoCoordinate> readCoordinates()
-        {
-            std::uint16_t coordSize;
-            dataFile_.read(reinterpret_cast<char*>(&coordSize), sizeof(coordSize));
+        Source& source_;
 
-            std::vector<GeoCoordinate> coordinates;
-            coordinates.reserve(coordSize);
-            for (std::size_t i = 0; i < coordSize; ++i) {
-                coordinates.push_back(readCoordinate());
-            }
+        Node node_;
+        Way way_;
+        Area area_;
+        Relation relation_;
+    };
+
+    /// Gets data format version from header bytes.
+    std::uint8_t getDataVersion(const char* header, std::size_t size)
+    {
+        if (size < DataHeaderSize || !std::equal(std::begin(DataHeaderMagic), std::end(DataHeaderMagic), header))
+            return 1;
+
+        return static_cast<std::uint8_t>(header[DataHeaderSize - 1]);
+    }
+
+    /// Reads data format version from header of given source.
+    template <typename Source>
+    std::uint8_t readDataVersion(Source& dataSource)
+    {
+        char header[DataHeaderSize];
+        dataSource.seek(0);
+        for (std::size_t i = 0; i < DataHeaderSize; ++i)
+            dataSource.read(header[i]);
+        return getDataVersion(header, DataHeaderSize);
+    }
+
+    /// Parses quadkey from its string representation. Returns false if string is not a quadkey.
+    bool parseQuadKey(int levelOfDetail, const std::string& code, QuadKey& quadKey)
+    {
+        if (levelOfDetail <= 0 || code.size() != static_cast<std::size_t>(levelOfDetail))
+            return false;
+
+        quadKey = QuadKey(levelOfDetail, 0, 0);
+        for (int i = levelOfDetail; i > 0; --i) {
+            int mask = 1 << (i - 1);
+            int digit = code[levelOfDetail - i] - '0';
+            if (digit < 0 || digit > 3)
+                return false;
+            if ((digit & 1) != 0)
+                quadKey.tileX |= mask;
+            if ((digit & 2) != 0)
+                quadKey.tileY |= mask;
+        }
+        return true;
+    }
+
+    /// Reads data format version of existing data file. Returns current version for new files.
+    std::uint8_t readDataVersion(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        char header[DataHeaderSize];
+        file.read(header, DataHeaderSize);
+        std::size_t size = static_cast<std::size_t>(file.gcount());
+        return size == 0 ? CurrentDataVersion : getDataVersion(header, size);
+    }
+
+    /// Reads given amount of elements listed in index.
+    template <typename Source, typename Format>
+    void readElements(Source& indexSource, std::uint32_t count, Source& dataSource, ElementVisitor& visitor)
+    {
+        ElementReader<Source, Format> reader(dataSource);
+        indexSource.seek(0);
+        for (std::uint32_t i = 0; i < count; ++i) {
+            std::uint64_t id;
+            std::uint32_t offset;
+            indexSource.read(id);
+            indexSource.read(offset);
+
+            reader.readElement(id, offset).accept(visitor);
+        }
+    }
+
+    /// Reads elements listed in given entries.
+    template <typename Source, typename Format>
+    void readElements(const IndexEntries& entries, Source& dataSource, ElementVisitor& visitor)
+    {
+        ElementReader<Source, Format> reader(dataSource);
+        for (const auto& entry : entries)
+            reader.readElement(entry.first, entry.second).accept(visitor);
+    }
 
-            return std::move(coordinates);
+    /// Reads elements listed in given entries using format specified in data header.
+    template <typename Source>
+    void readElements(const IndexEntries& entries, Source& dataSource, ElementVisitor& visitor)
+    {
+        switch (readDataVersion(dataSource)) {
+        case 1:
+            readElements<Source, RawFormat>(entries, dataSource, visitor);
+            break;
+        case 2:
+            readElements<Source, CompactFormat>(entries, dataSource, visitor);
+            break;
+        default:
+            throw std::domain_error("Unsupported data file version.");
         }
+    }
 
-        inline std::vector<Tag> readTags()
+    /// Reads given amount of elements listed in index using format specified in data header.
+    template <typename Source>
+    void readElements(Source& indexSource, std::uint32_t count, Source& dataSource, ElementVisitor& visitor)
+    {
+        switch (readDataVersion(dataSource)) {
+        case 1:
+            readElements<Source, RawFormat>(indexSource, count, dataSource, visitor);
+            break;
+        case 2:
+            readElements<Source, CompactFormat>(indexSource, count, dataSource, visitor);
+            break;
+        default:
+            throw std::domain_error("Unsupported data file version.");
+        }
+    }
+
+    /// Collects bounding boxes of visited elements.
+    class BoundingBoxCollector final : public ElementVisitor
+    {
+    public:
+        explicit BoundingBoxCollector(std::vector<BoundingBox>& boxes) : boxes_(boxes)
         {
-            std::uint16_t tagSize;
-            dataFile_.read(reinterpret_cast<char*>(&tagSize), sizeof(tagSize));
+        }
 
-            std::vector<Tag> tags;
-            for (std::size_t i = 0; i < tagSize; ++i) {
-                Tag tag;
-                dataFile_.read(reinterpret_cast<char*>(&tag.key), sizeof(tag.key));
-                dataFile_.read(reinterpret_cast<char*>(&tag.value), sizeof(tag.value));
-                tags.push_back(tag);
-            }
+        void visitNode(const Node& node) override { add(node); }
 
-            return std::move(tags);
+        void visitWay(const Way& way) override { add(way); }
+
+        void visitArea(const Area& area) override { add(area); }
+
+        void visitRelation(const Relation& relation) override { add(relation); }
+
+    private:
+        void add(const Element& element)
+        {
+            BoundingBoxVisitor visitor;
+            element.accept(visitor);
+            boxes_.push_back(visitor.boundingBox);
         }
 
-        std::fstream& dataFile_;
+        std::vector<BoundingBox>& boxes_;
     };
+
+    /// Appends spatial index entry to buffer.
+    void appendSpatialEntry(std::vector<char>& buffer, const BoundingBox& bbox, const ElementLocation& location)
+    {
+        append(buffer, bbox.minPoint.latitude);
+        append(buffer, bbox.minPoint.longitude);
+        append(buffer, bbox.maxPoint.latitude);
+        append(buffer, bbox.maxPoint.longitude);
+        append(buffer, location.id);
+        append(buffer, static_cast<std::int32_t>(location.quadKey.levelOfDetail));
+        append(buffer, static_cast<std::int32_t>(location.quadKey.tileX));
+        append(buffer, static_cast<std::int32_t>(location.quadKey.tileY));
+        append(buffer, location.offset);
+    }
+
+    /// Reads spatial index entry from source.
+    template <typename Source>
+    std::pair<BoundingBox, ElementLocation> readSpatialEntry(Source& source)
+    {
+        double values[4];
+        for (auto& value : values)
+            source.read(value);
+
+        ElementLocation location;
+        std::int32_t quadKey[3];
+        source.read(location.id);
+        for (auto& value : quadKey)
+            source.read(value);
+        source.read(location.offset);
+        location.quadKey = QuadKey(quadKey[0], quadKey[1], quadKey[2]);
+
+        return std::make_pair(BoundingBox(GeoCoordinate(values[0], values[1]), GeoCoordinate(values[2], values[3])),
+                              location);
+    }
 }
 
+/// Keeps set of quadkeys with data in memory, so existence checks do not touch file system.
+/// The set is persisted in manifest file which is appended when new data file is created.
+/// In-memory state is guarded by mutex, so searches can be done from multiple threads: files are
+/// read outside of lock. NOTE storing elements while searching the same quadkey is not supported.
+/// Spatial index refers to elements already written to quadkey data files. Only elements which are
+/// stored clipped have their original geometry written to spatial data file.
 class PersistentElementStore::PersistentElementStoreImpl final
 {
+    typedef std::map<QuadKey, QuadKeyBuffer, QuadKey::Comparator> BufferMap;
+    typedef std::set<QuadKey, QuadKey::Comparator> QuadKeySet;
+    typedef SpatialIndex<ElementLocation> ElementSpatialIndex;
+
 public:
-    explicit PersistentElementStoreImpl(const std::string& dataPath)
-            : dataPath_(dataPath)
+    PersistentElementStoreImpl(const std::string& dataPath, ReadMode readMode,
+                               std::size_t bufferSize, std::size_t maxOpenFiles)
+            : dataPath_(dataPath), readMode_(readMode), bufferSize_(bufferSize),
+              bufferedSize_(0), buffers_(), files_(maxOpenFiles), quadKeys_(), manifest_(),
+              spatialBuffer_(CurrentDataVersion, 0), spatialEntries_(), spatialIndex_()
     {
+        loadManifest();
+        loadSpatialIndex();
     }
 
     void store(const Element& element, const QuadKey& quadKey)
     {
-        ensureFiles(quadKey);
+        std::lock_guard<std::mutex> lock(lock_);
+        storeElement(element, quadKey);
 
-        // write element data
-        std::uint32_t offset = static_cast<std::uint32_t>(dataFile_.tellg());
+        if (bufferedSize_ > bufferSize_)
+            flush();
+    }
 
-        ElementWriter visitor(dataFile_);
-        element.accept(visitor);
+    void storeIndexed(const Element& element, const QuadKey& quadKey, const BoundingBox& bbox)
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        // NOTE element is stored as is, so spatial index refers to its quadkey data.
+        spatialEntries_.push_back(std::make_pair(bbox, storeElement(element, quadKey)));
 
-        // write element index
-        indexFile_.seekg(0, std::ios::end);
-        indexFile_.write(reinterpret_cast<const char*>(&element.id), sizeof(element.id));
-        indexFile_.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+        bufferedSize_ += SpatialEntrySize;
+        if (bufferedSize_ > bufferSize_)
+            flush();
     }
 
     void search(const QuadKey& quadKey, ElementVisitor& visitor)
     {
-        ensureFiles(quadKey);
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            // NOTE pending writes to the same quadkey should be visible.
+            flush(quadKey);
 
-        std::uint32_t count = static_cast<std::uint32_t>(indexFile_.tellg() /
-                (sizeof(std::uint64_t) + sizeof(std::uint32_t)));
+            if (quadKeys_.find(quadKey) == quadKeys_.end())
+                return;
+        }
 
-        ElementReader reader(dataFile_);
+        if (readMode_ == ReadMode::Mapped)
+            searchMapped(quadKey, visitor);
+        else
+            searchStream(quadKey, visitor);
+    }
 
-        indexFile_.seekg(0, std::ios::beg);
-        for (std::uint32_t i = 0; i < count; ++i) {
-            std::uint64_t id;
-            std::uint32_t offset;
-            indexFile_.read(reinterpret_cast<char*>(&id), sizeof(id));
-            indexFile_.read(reinterpret_cast<char*>(&offset), sizeof(offset));
+    void storeSpatial(const Element& element, const BoundingBox& bbox)
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        std::size_t offset = spatialBuffer_.data.size();
+        writeElement(element, spatialBuffer_);
+        spatialEntries_.push_back(std::make_pair(bbox, ElementLocation { element.id, QuadKey(), spatialBuffer_.fileOffset + offset }));
+
+        bufferedSize_ += spatialBuffer_.data.size() - offset + SpatialEntrySize;
+        if (bufferedSize_ > bufferSize_)
+            flush();
+    }
+
+    void search(const GeoCoordinate& coordinate, double radius, ElementVisitor& visitor)
+    {
+        std::vector<ElementLocation> locations;
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            // NOTE spatial index refers to data of all quadkeys.
+            flush();
+            std::set<std::uint64_t> ids;
+            spatialIndex_.search(coordinate, radius, [&](const ElementLocation& location) {
+                if (location.id == 0 || ids.insert(location.id).second)
+                    locations.push_back(location);
+            });
+        }
+
+        // NOTE read elements file by file in file order.
+        QuadKey::Comparator comparator;
+        std::sort(locations.begin(), locations.end(), [&](const ElementLocation& lhs, const ElementLocation& rhs) {
+            return comparator(lhs.quadKey, rhs.quadKey) ||
+                   (lhs.quadKey == rhs.quadKey && lhs.offset < rhs.offset);
+        });
+
+        IndexEntries entries;
+        for (std::size_t i = 0; i < locations.size(); ++i) {
+            entries.push_back(std::make_pair(locations[i].id, locations[i].offset));
+            if (i + 1 < locations.size() && locations[i + 1].quadKey == locations[i].quadKey)
+                continue;
 
-            reader.readElement(id, offset)->accept(visitor);
+            std::string dataPath = locations[i].quadKey.levelOfDetail == 0
+                ? dataPath_ + SpatialDataFileName
+                : getFilePath(locations[i].quadKey, DataFileExtension);
+            if (readMode_ == ReadMode::Mapped) {
+                MappedFile dataFile(dataPath);
+                MappedSource dataSource(dataFile.data(), dataFile.size());
+                readElements(entries, dataSource, visitor);
+            } else {
+                std::ifstream dataFile(dataPath, std::ios::in | std::ios::binary);
+                StreamSource dataSource(dataFile);
+                readElements(entries, dataSource, visitor);
+            }
+            entries.clear();
         }
     }
 
     bool hasData(const QuadKey& quadKey) const
     {
-        std::ifstream file(getFilePath(quadKey, DataFileExtension));
-        return file.good();
+        std::lock_guard<std::mutex> lock(lock_);
+        return buffers_.find(quadKey) != buffers_.end() ||
+               quadKeys_.find(quadKey) != quadKeys_.end();
     }
 
     void commit()
     {
-        closeFiles();
-        currentQuadKey_ = QuadKey();
+        std::lock_guard<std::mutex> lock(lock_);
+        flush();
+        files_.clear();
+        manifest_.flush();
     }
 
 private:
-    /// Gets full file path for given quadkey
-    std::string getFilePath(const QuadKey& quadKey, const std::string& extension) const
+    /// Reads manifest or creates it from existing data files if it is missing.
+    void loadManifest()
     {
-        std::stringstream ss;
-        ss << dataPath_ << quadKey.levelOfDetail << "/" << GeoUtils::quadKeyToString(quadKey) << extension;
-        return ss.str();
+        std::string path = dataPath_ + ManifestFileName;
+        std::ifstream manifest(path, std::ios::in | std::ios::binary);
+        if (manifest.good()) {
+            std::int32_t values[3];
+            while (manifest.read(reinterpret_cast<char*>(values), sizeof(values)))
+                quadKeys_.insert(QuadKey(values[0], values[1], values[2]));
+            manifest.close();
+            manifest_.open(path, std::ios::out | std::ios::binary | std::ios::app);
+            return;
+        }
+
+        // NOTE data might be created by version without manifest support.
+        scanDataFiles();
+        manifest_.open(path, std::ios::out | std::ios::binary | std::ios::app);
+        for (const auto& quadKey : quadKeys_)
+            writeManifest(quadKey);
+        manifest_.flush();
     }
 
-    /// Ensures that open/close function is called on files.
-    void ensureFiles(const QuadKey& quadKey)
+    /// Loads spatial index or rebuilds it from quadkey files if it is missing or has old format.
+    void loadSpatialIndex()
     {
-        if (quadKey == currentQuadKey_)
+        namespace fs = boost::filesystem;
+        boost::system::error_code ec;
+        auto dataSize = fs::file_size(dataPath_ + SpatialDataFileName, ec);
+        spatialBuffer_.fileOffset = ec || dataSize == 0 ? DataHeaderSize : dataSize;
+
+        std::string indexPath = dataPath_ + SpatialIndexFileName;
+        if (!readSpatialIndex(indexPath)) {
+            // NOTE data might be created by version without spatial index or with old one.
+            if (fs::exists(indexPath, ec) || !quadKeys_.empty())
+                rebuildSpatialIndex();
+        }
+    }
+
+    /// Reads spatial index from file. Returns false if file is missing or has unsupported format.
+    bool readSpatialIndex(const std::string& path)
+    {
+        MappedFile indexFile(path);
+        if (indexFile.size() < DataHeaderSize)
+            return false;
+
+        MappedSource indexSource(indexFile.data(), indexFile.size());
+        char header[DataHeaderSize];
+        for (auto& value : header)
+            indexSource.read(value);
+        if (!std::equal(std::begin(SpatialHeaderMagic), std::end(SpatialHeaderMagic), header) ||
+            static_cast<std::uint8_t>(header[DataHeaderSize - 1]) != SpatialIndexVersion)
+            return false;
+
+        SpatialEntries items;
+        std::size_t count = (indexFile.size() - DataHeaderSize) / SpatialEntrySize;
+        items.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+            items.push_back(readSpatialEntry(indexSource));
+        spatialIndex_ = ElementSpatialIndex(items);
+        return true;
+    }
+
+    /// Creates spatial index from elements stored in quadkey files.
+    /// NOTE original geometry of clipped elements is not available, so
+    /// every clipped part is indexed and the first found one is returned.
+    void rebuildSpatialIndex()
+    {
+        // NOTE existing spatial data is not referenced by new index.
+        std::remove((dataPath_ + SpatialDataFileName).c_str());
+        spatialBuffer_.fileOffset = DataHeaderSize;
+
+        SpatialEntries items;
+        std::vector<BoundingBox> boxes;
+        for (const auto& quadKey : quadKeys_) {
+            IndexEntries entries;
+            MappedFile indexFile(getFilePath(quadKey, IndexFileExtension));
+            MappedSource indexSource(indexFile.data(), indexFile.size());
+            std::size_t count = indexFile.size() / IndexEntrySize;
+            entries.reserve(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                std::uint64_t id;
+                std::uint32_t offset;
+                indexSource.read(id);
+                indexSource.read(offset);
+                entries.push_back(std::make_pair(id, offset));
+            }
+            if (entries.empty())
+                continue;
+
+            boxes.clear();
+            BoundingBoxCollector collector(boxes);
+            MappedFile dataFile(getFilePath(quadKey, DataFileExtension));
+            MappedSource dataSource(dataFile.data(), dataFile.size());
+            readElements(entries, dataSource, collector);
+
+            for (std::size_t i = 0; i < entries.size(); ++i) {
+                if (boxes[i].isValid())
+                    items.push_back(std::make_pair(boxes[i], ElementLocation { entries[i].first, quadKey, entries[i].second }));
+            }
+        }
+
+        std::vector<char> index;
+        index.reserve(DataHeaderSize + items.size() * SpatialEntrySize);
+        index.insert(index.end(), std::begin(SpatialHeaderMagic), std::end(SpatialHeaderMagic));
+        index.push_back(static_cast<char>(SpatialIndexVersion));
+        for (const auto& item : items)
+            appendSpatialEntry(index, item.first, item.second);
+
+        std::ofstream indexFile(dataPath_ + SpatialIndexFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+        indexFile.write(index.data(), index.size());
+        if (!indexFile.good())
+            throw std::domain_error("Cannot write spatial index in:" + dataPath_);
+
+        spatialIndex_ = ElementSpatialIndex(items);
+    }
+
+    /// Finds all data files stored in level of detail directories.
+    void scanDataFiles()
+    {
+        namespace fs = boost::filesystem;
+        boost::system::error_code ec;
+        fs::path root(dataPath_.empty() ? "." : dataPath_);
+        for (fs::directory_iterator dirEnd, dir(root, ec); !ec && dir != dirEnd; dir.increment(ec)) {
+            std::string name = dir->path().filename().string();
+            if (!fs::is_directory(dir->status()) || name.empty() ||
+                name.find_first_not_of("0123456789") != std::string::npos || name.size() > 2)
+                continue;
+
+            int levelOfDetail = std::stoi(name);
+            for (fs::directory_iterator fileEnd, file(dir->path(), ec); !ec && file != fileEnd; file.increment(ec)) {
+                QuadKey quadKey;
+                if (file->path().extension().string() == DataFileExtension &&
+                    parseQuadKey(levelOfDetail, file->path().stem().string(), quadKey))
+                    quadKeys_.insert(quadKey);
+            }
+        }
+    }
+
+    void writeManifest(const QuadKey& quadKey)
+    {
+        std::int32_t values[3] = { quadKey.levelOfDetail, quadKey.tileX, quadKey.tileY };
+        manifest_.write(reinterpret_cast<const char*>(values), sizeof(values));
+    }
+
+    /// Creates buffer for given quadkey using format and size of existing data file.
+    QuadKeyBuffer createBuffer(const QuadKey& quadKey) const
+    {
+        // NOTE only existing file can have version other than current one.
+        if (quadKeys_.find(quadKey) == quadKeys_.end())
+            return QuadKeyBuffer(CurrentDataVersion, DataHeaderSize);
+
+        const std::string path = getFilePath(quadKey, DataFileExtension);
+        auto version = readDataVersion(path);
+        boost::system::error_code ec;
+        auto size = boost::filesystem::file_size(path, ec);
+        if (ec || size == 0)
+            return QuadKeyBuffer(version, version == 1 ? 0 : DataHeaderSize);
+        return QuadKeyBuffer(version, size);
+    }
+
+    /// Reads elements using file streams.
+    void searchStream(const QuadKey& quadKey, ElementVisitor& visitor)
+    {
+        using std::ios;
+        std::ifstream indexFile(getFilePath(quadKey, IndexFileExtension), ios::in | ios::binary | ios::ate);
+        std::ifstream dataFile(getFilePath(quadKey, DataFileExtension), ios::in | ios::binary);
+        if (!indexFile.good() || !dataFile.good())
+            return;
+
+        std::uint32_t count = static_cast<std::uint32_t>(indexFile.tellg() / IndexEntrySize);
+
+        StreamSource indexSource(indexFile);
+        StreamSource dataSource(dataFile);
+        readElements(indexSource, count, dataSource, visitor);
+    }
+
+    /// Reads elements directly from memory mapped files.
+    void searchMapped(const QuadKey& quadKey, ElementVisitor& visitor)
+    {
+        MappedFile indexFile(getFilePath(quadKey, IndexFileExtension));
+        MappedFile dataFile(getFilePath(quadKey, DataFileExtension));
+
+        std::uint32_t count = static_cast<std::uint32_t>(indexFile.size() / IndexEntrySize);
+        if (count == 0)
+            return;
+
+        MappedSource indexSource(indexFile.data(), indexFile.size());
+        MappedSource dataSource(dataFile.data(), dataFile.size());
+        readElements(indexSource, count, dataSource, visitor);
+    }
+
+    /// Writes element into buffer of given quadkey. Should be called under lock.
+    ElementLocation storeElement(const Element& element, const QuadKey& quadKey)
+    {
+        auto it = buffers_.find(quadKey);
+        if (it == buffers_.end())
+            it = buffers_.emplace(quadKey, createBuffer(quadKey)).first;
+
+        auto& buffer = it->second;
+        std::size_t offset = buffer.data.size();
+        if (buffer.fileOffset + offset > std::numeric_limits<std::uint32_t>::max())
+            throw std::length_error("Data file is too large: " + getFilePath(quadKey, DataFileExtension));
+
+        writeElement(element, buffer);
+        buffer.entries.push_back(std::make_pair(element.id, offset));
+
+        bufferedSize_ += buffer.data.size() - offset + IndexEntrySize;
+        return ElementLocation { element.id, quadKey, buffer.fileOffset + offset };
+    }
+
+    /// Serializes element into buffer using format of target file.
+    static void writeElement(const Element& element, QuadKeyBuffer& buffer)
+    {
+        if (buffer.version == 1) {
+            ElementWriter<RawFormat> visitor(buffer.data);
+            element.accept(visitor);
+        } else {
+            ElementWriter<CompactFormat> visitor(buffer.data);
+            element.accept(visitor);
+        }
+    }
+
+    /// Flushes all buffered elements to disk.
+    void flush()
+    {
+        for (const auto& pair : buffers_)
+            write(pair.first, pair.second);
+
+        // NOTE spatial entries can refer to quadkey data, so they are written last.
+        flushSpatial();
+
+        buffers_.clear();
+        bufferedSize_ = 0;
+    }
+
+    /// Flushes buffered elements of given quadkey to disk.
+    void flush(const QuadKey& quadKey)
+    {
+        auto it = buffers_.find(quadKey);
+        if (it == buffers_.end())
+            return;
+
+        write(it->first, it->second);
+        bufferedSize_ -= it->second.data.size() + it->second.entries.size() * IndexEntrySize;
+        buffers_.erase(it);
+    }
+
+    /// Flushes buffered spatial data to disk and adds it to spatial index.
+    void flushSpatial()
+    {
+        if (spatialEntries_.empty())
             return;
 
-        closeFiles();
-        
         using std::ios;
-        dataFile_.open(getFilePath(quadKey, DataFileExtension), ios::in | ios::out | ios::binary | ios::app | ios::ate);
-        indexFile_.open(getFilePath(quadKey, IndexFileExtension),ios::in | ios::out | ios::binary | ios::app | ios::ate);
+        if (!spatialBuffer_.data.empty()) {
+            std::ofstream dataFile(dataPath_ + SpatialDataFileName, ios::out | ios::binary | ios::app | ios::ate);
+            spatialBuffer_.fileOffset = writeData(dataFile, spatialBuffer_) + spatialBuffer_.data.size();
+            spatialBuffer_.data.clear();
+        }
+
+        std::vector<char> index;
+        std::ofstream indexFile(dataPath_ + SpatialIndexFileName, ios::out | ios::binary | ios::app | ios::ate);
+        if (indexFile.tellp() == 0) {
+            index.insert(index.end(), std::begin(SpatialHeaderMagic), std::end(SpatialHeaderMagic));
+            index.push_back(static_cast<char>(SpatialIndexVersion));
+        }
 
-        currentQuadKey_ = quadKey;
+        index.reserve(index.size() + spatialEntries_.size() * SpatialEntrySize);
+        for (const auto& entry : spatialEntries_) {
+            appendSpatialEntry(index, entry.first, entry.second);
+            spatialIndex_.insert(entry.first, entry.second);
+        }
+        indexFile.write(index.data(), index.size());
+        spatialEntries_.clear();
     }
 
-    void closeFiles()
+    /// Appends buffered data to data file adding header to new file. Returns offset of buffer in file.
+    static std::uint64_t writeData(std::ofstream& data, const QuadKeyBuffer& buffer)
     {
-        if (dataFile_.good()) dataFile_.close();
-        if (indexFile_.good()) indexFile_.close();
+        std::uint64_t dataOffset = static_cast<std::uint64_t>(data.tellp());
+        if (dataOffset == 0 && buffer.version != 1) {
+            data.write(DataHeaderMagic, sizeof(DataHeaderMagic));
+            data.put(static_cast<char>(buffer.version));
+            dataOffset = DataHeaderSize;
+        }
+        data.write(buffer.data.data(), buffer.data.size());
+        data.flush();
+        return dataOffset;
+    }
+
+    /// Appends buffer content to quadkey files using one write per file.
+    void write(const QuadKey& quadKey, const QuadKeyBuffer& buffer)
+    {
+        auto& files = files_.get(quadKey,
+                                 getFilePath(quadKey, IndexFileExtension),
+                                 getFilePath(quadKey, DataFileExtension));
+
+        // NOTE quadkey data file size is checked on store, so offsets fit into index entries.
+        std::uint32_t dataOffset = static_cast<std::uint32_t>(writeData(files.data, buffer));
+
+        std::vector<char> index;
+        index.reserve(buffer.entries.size() * IndexEntrySize);
+        for (const auto& entry : buffer.entries) {
+            append(index, entry.first);
+            append(index, static_cast<std::uint32_t>(dataOffset + entry.second));
+        }
+        files.index.write(index.data(), index.size());
+        files.index.flush();
+
+        if (quadKeys_.insert(quadKey).second) {
+            writeManifest(quadKey);
+            manifest_.flush();
+        }
+    }
+
+    /// Gets full file path for given quadkey
+    std::string getFilePath(const QuadKey& quadKey, const std::string& extension) const
+    {
+        std::stringstream ss;
+        ss << dataPath_ << quadKey.levelOfDetail << "/" << GeoUtils::quadKeyToString(quadKey) << extension;
+        return ss.str();
     }
 
     const std::string dataPath_;
-    
-    QuadKey currentQuadKey_;
+    const ReadMode readMode_;
+    const std::size_t bufferSize_;
+
+    std::size_t bufferedSize_;
+    BufferMap buffers_;
+    FileCache files_;
 
-    std::fstream indexFile_;
-    std::fstream dataFile_;
+    QuadKeySet quadKeys_;
+    std::ofstream manifest_;
+
+    /// Original elements which are stored clipped.
+    QuadKeyBuffer spatialBuffer_;
+    SpatialEntries spatialEntries_;
+    ElementSpatialIndex spatialIndex_;
+
+    mutable std::mutex lock_;
 };
 
-PersistentElementStore::PersistentElementStore(const std::string& dataPath, StringTable& stringTable) :
-    ElementStore(stringTable), pimpl_(utymap::utils::make_unique<PersistentElementStoreImpl>(dataPath))
+PersistentElementStore::PersistentElementStore(const std::string& dataPath,
+                                               StringTable& stringTable,
+                                               ReadMode readMode,
+                                               std::size_t bufferSize,
+                                               std::size_t maxOpenFiles,
+                                               std::size_t clipThreads) :
+    ElementStore(stringTable, clipThreads),
+    pimpl_(utymap::utils::make_unique<PersistentElementStoreImpl>(dataPath, readMode, bufferSize, maxOpenFiles))
 {
 }
 
@@ -344,6 +1300,21 @@ void PersistentElementStore::storeImpl(const Element& element, const QuadKey& qu
     pimpl_->store(element, quadKey);
 }
 
+void PersistentElementStore::storeIndexedImpl(const Element& element, const QuadKey& quadKey, const BoundingBox& bbox)
+{
+    pimpl_->storeIndexed(element, quadKey, bbox);
+}
+
+void PersistentElementStore::storeSpatialImpl(const Element& element, const BoundingBox& bbox)
+{
+    pimpl_->storeSpatial(element, bbox);
+}
+
+void PersistentElementStore::search(const GeoCoordinate& coordinate, double radius, ElementVisitor& visitor)
+{
+    pimpl_->search(coordinate, radius, visitor);
+}
+
 void PersistentElementStore::search(const QuadKey& quadKey, ElementVisitor& visitor)
 {
     pimpl_->search(quadKey, visitor);
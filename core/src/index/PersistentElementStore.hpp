@@ -5,6 +5,7 @@
 #include "entities/Element.hpp"
 #include "index/ElementStore.hpp"
 
+#include <cstddef>
 #include <string>
 #include <memory>
 
@@ -14,14 +15,39 @@ namespace utymap { namespace index {
 class PersistentElementStore final : public ElementStore
 {
 public:
-    explicit PersistentElementStore(const std::string& path,
-                           utymap::index::StringTable& stringTable);
+    /// Specifies the way how element data is read from disk.
+    enum class ReadMode
+    {
+        /// Uses file streams.
+        Stream,
+        /// Maps index and data files into memory and decodes elements in place.
+        Mapped
+    };
+
+    /// Creates store in given path.
+    /// Elements are buffered in memory per quadkey and flushed to disk on commit or
+    /// when buffered data exceeds buffer size (in bytes). Amount of simultaneously
+    /// opened files is limited by max open files. Clip threads are passed to ElementStore.
+    /// Quadkeys with data are listed in manifest file, which is built from existing
+    /// data files if missing. Spatial index used by radius search is rebuilt from data
+    /// files if it is missing too. Data directory should not be modified by others while
+    /// store is in use.
+    PersistentElementStore(const std::string& path,
+                           utymap::index::StringTable& stringTable,
+                           ReadMode readMode = ReadMode::Mapped,
+                           std::size_t bufferSize = 16 * 1024 * 1024,
+                           std::size_t maxOpenFiles = 64,
+                           std::size_t clipThreads = 0);
 
     virtual ~PersistentElementStore();
 
     void search(const utymap::QuadKey& quadKey, 
                 utymap::entities::ElementVisitor& visitor) override;
 
+    void search(const utymap::GeoCoordinate& coordinate,
+                double radius,
+                utymap::entities::ElementVisitor& visitor) override;
+
     bool hasData(const utymap::QuadKey& quadKey) const override;
 
     void commit() override;
@@ -29,6 +55,12 @@ public:
 protected:
     void storeImpl(const utymap::entities::Element& element, const utymap::QuadKey& quadKey) override;
 
+    void storeIndexedImpl(const utymap::entities::Element& element,
+                          const utymap::QuadKey& quadKey,
+                          const utymap::BoundingBox& bbox) override;
+
+    void storeSpatialImpl(const utymap::entities::Element& element, const utymap::BoundingBox& bbox) override;
+
 private:
     class PersistentElementStoreImpl;
     std::unique_ptr<PersistentElementStoreImpl> pimpl_;
@@ -0,0 +1,95 @@
+#ifndef INDEX_SPATIALINDEX_HPP_DEFINED
+#define INDEX_SPATIALINDEX_HPP_DEFINED
+
+#include "BoundingBox.hpp"
+#include "GeoCoordinate.hpp"
+#include "utils/GeoUtils.hpp"
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace utymap { namespace index {
+
+/// Provides R-tree over bounding boxes of elements which is used for radius search.
+/// NOTE coordinates are treated as planar, so boxes crossing 180th meridian are not supported.
+template <typename Value>
+class SpatialIndex final
+{
+    typedef boost::geometry::model::point<double, 2, boost::geometry::cs::cartesian> Point;
+    typedef boost::geometry::model::box<Point> Box;
+    typedef std::pair<Box, Value> Entry;
+    typedef boost::geometry::index::rtree<Entry, boost::geometry::index::rstar<16>> RTree;
+
+public:
+    SpatialIndex() : rtree_()
+    {
+    }
+
+    /// Creates index from given items using bulk loading which produces packed tree.
+    explicit SpatialIndex(const std::vector<std::pair<BoundingBox, Value>>& items) :
+        rtree_(createEntries(items))
+    {
+    }
+
+    /// Adds value with given bounding box to index.
+    void insert(const BoundingBox& bbox, const Value& value)
+    {
+        rtree_.insert(std::make_pair(toBox(bbox), value));
+    }
+
+    /// Calls visitor for every value which bounding box is within given radius (in meters) from center.
+    template <typename Visitor>
+    void search(const GeoCoordinate& center, double radius, const Visitor& visitor) const
+    {
+        double latOffset = utymap::utils::GeoUtils::getOffset(center, radius);
+        double lonOffset = std::min(180., latOffset / std::max(std::cos(utymap::utils::deg2Rad(center.latitude)), 1E-6));
+        Box query(Point(center.latitude - latOffset, center.longitude - lonOffset),
+                  Point(center.latitude + latOffset, center.longitude + lonOffset));
+
+        namespace bgi = boost::geometry::index;
+        for (auto it = rtree_.qbegin(bgi::intersects(query)); it != rtree_.qend(); ++it) {
+            if (getDistance(center, it->first) <= radius)
+                visitor(it->second);
+        }
+    }
+
+    /// Returns amount of values in index.
+    std::size_t size() const { return rtree_.size(); }
+
+private:
+    static Box toBox(const BoundingBox& bbox)
+    {
+        return Box(Point(bbox.minPoint.latitude, bbox.minPoint.longitude),
+                   Point(bbox.maxPoint.latitude, bbox.maxPoint.longitude));
+    }
+
+    static std::vector<Entry> createEntries(const std::vector<std::pair<BoundingBox, Value>>& items)
+    {
+        std::vector<Entry> entries;
+        entries.reserve(items.size());
+        for (const auto& item : items)
+            entries.push_back(std::make_pair(toBox(item.first), item.second));
+        return entries;
+    }
+
+    /// Gets distance in meters from point to the closest point of box.
+    static double getDistance(const GeoCoordinate& point, const Box& box)
+    {
+        const auto& min = box.min_corner();
+        const auto& max = box.max_corner();
+        GeoCoordinate closest(std::max(min.get<0>(), std::min(point.latitude, max.get<0>())),
+                              std::max(min.get<1>(), std::min(point.longitude, max.get<1>())));
+        return utymap::utils::GeoUtils::distance(point, closest);
+    }
+
+    RTree rtree_;
+};
+
+}}
+
+#endif // INDEX_SPATIALINDEX_HPP_DEFINED
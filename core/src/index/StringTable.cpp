@@ -2,118 +2,318 @@
 #include "index/StringTable.hpp"
 #include "utils/CoreUtils.hpp"
 
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <iterator>
 #include <mutex>
-#include <unordered_map>
 #include <vector>
 
 using std::ios;
 using namespace utymap::index;
 
-/// Naive implementation of string table: reads all the time string from file; acquires lock
-/// TODO optimize it to avoid locks and expensive file reads.
+namespace {
+    /// Size of arena block used for strings.
+    const std::size_t ArenaBlockSize = 64 * 1024;
+    /// Size of the first entry segment, each next segment is twice bigger.
+    const std::uint32_t FirstSegmentSize = 1024;
+    /// Max amount of entry segments: enough for any 32 bit id.
+    const std::size_t MaxSegments = 23;
+    /// Initial capacity of hash index, must be power of two.
+    const std::uint32_t InitialIndexCapacity = 4096;
+
+    /// Represents string stored in arena.
+    struct Entry final
+    {
+        const char* data;
+        std::uint32_t size;
+        std::uint32_t hash;
+        /// Numeric value of string used by numeric comparisons.
+        double number;
+    };
+
+    /// Parses null terminated string as decimal number. Returns zero if it is not a number.
+    /// NOTE most of strings are not numbers, so they are rejected without exception.
+    double parseNumber(const char* str, std::uint32_t size)
+    {
+        if (size == 0 || std::strspn(str, "0123456789+-.eE") != size)
+            return 0;
+
+        char* end;
+        double value = std::strtod(str, &end);
+        return end == str + size ? value : 0;
+    }
+
+    /// Append only storage of null terminated strings: allocated memory is never moved.
+    class StringArena final
+    {
+    public:
+        StringArena() : blocks_(), current_(nullptr), left_(0)
+        {
+        }
+
+        const char* append(const char* str, std::size_t size)
+        {
+            std::size_t required = size + 1;
+            if (required > left_) {
+                std::size_t blockSize = std::max(ArenaBlockSize, required);
+                blocks_.push_back(std::unique_ptr<char[]>(new char[blockSize]));
+                current_ = blocks_.back().get();
+                left_ = blockSize;
+            }
+
+            char* data = current_;
+            std::memcpy(data, str, size);
+            data[size] = '\0';
+
+            current_ += required;
+            left_ -= required;
+            return data;
+        }
+
+    private:
+        std::vector<std::unique_ptr<char[]>> blocks_;
+        char* current_;
+        std::size_t left_;
+    };
+
+    /// Open addressing hash index which maps string hash to id. Slot keeps id + 1, zero means empty.
+    struct HashIndex final
+    {
+        explicit HashIndex(std::uint32_t capacity) :
+            mask(capacity - 1), slots(new std::atomic<std::uint32_t>[capacity])
+        {
+            for (std::uint32_t i = 0; i < capacity; ++i)
+                slots[i].store(0, std::memory_order_relaxed);
+        }
+
+        std::uint32_t capacity() const { return mask + 1; }
+
+        const std::uint32_t mask;
+        std::unique_ptr<std::atomic<std::uint32_t>[]> slots;
+    };
+}
+
+/// Keeps all strings in memory: lookups are lock free, files are used only for persistence.
+/// Insertion of new strings is serialized by mutex, readers never wait for it.
 class StringTable::StringTableImpl
 {
-    typedef std::vector<std::uint32_t> IdList;
-    typedef std::unordered_map<std::uint32_t, IdList> HashIdMap;
-
 public:
     StringTableImpl(const std::string& indexPath, const std::string& dataPath, std::uint32_t seed) :
         indexFile_(indexPath, ios::in | ios::out | ios::binary | ios::ate | ios::app),
         dataFile_(dataPath, ios::in | ios::out | ios::binary | ios::app),
         seed_(seed),
-        nextId_(0),
-        map_(),
-        offsets_()
-    {
-        nextId_ = static_cast<std::uint32_t>(indexFile_.tellg() / (sizeof(std::uint32_t) * 2));
-        if (nextId_ > 0) {
-            std::uint32_t count = nextId_;
-            offsets_.reserve(static_cast<std::size_t>(count));
-            indexFile_.seekg(0, ios::beg);
-            for (std::uint32_t i = 0; i < count; ++i) {
-                std::uint32_t hash, offset;
-                indexFile_.read(reinterpret_cast<char*>(&hash), sizeof(hash));
-                indexFile_.read(reinterpret_cast<char*>(&offset), sizeof(offset));
-                offsets_.push_back(offset);
-                map_[hash].push_back(i);
-            }
-        }
+        dataSize_(0),
+        count_(0),
+        arena_(),
+        indices_(),
+        index_(nullptr)
+    {
+        for (auto& segment : segments_)
+            segment.store(nullptr, std::memory_order_relaxed);
+
+        indices_.push_back(utymap::utils::make_unique<HashIndex>(InitialIndexCapacity));
+        index_.store(indices_.back().get(), std::memory_order_relaxed);
+
+        load();
+    }
+
+    StringTableImpl(const StringTableImpl&) = delete;
+    StringTableImpl& operator=(const StringTableImpl&) = delete;
+
+    ~StringTableImpl()
+    {
+        for (auto& segment : segments_)
+            delete[] segment.load(std::memory_order_relaxed);
     }
 
     std::uint32_t getId(const std::string& str)
+    {
+        std::uint32_t hash = getHash(str);
+
+        std::uint32_t id;
+        if (find(str, hash, id))
+            return id;
+
+        std::lock_guard<std::mutex> lock(lock_);
+        // NOTE string might be added by another thread meanwhile.
+        if (find(str, hash, id))
+            return id;
+
+        id = add(str.c_str(), static_cast<std::uint32_t>(str.size()), hash);
+        writeString(hash, str);
+        return id;
+    }
+
+    std::string getString(std::uint32_t id) const
+    {
+        if (id >= count_.load(std::memory_order_acquire))
+            return "";
+
+        const Entry& entry = getEntry(id);
+        return std::string(entry.data, entry.size);
+    }
+
+    double getNumber(std::uint32_t id) const
+    {
+        if (id >= count_.load(std::memory_order_acquire))
+            return 0;
+
+        return getEntry(id).number;
+    }
+
+private:
+
+    std::uint32_t getHash(const std::string& str) const
     {
         std::uint32_t hash;
         MurmurHash3_x86_32(str.c_str(), static_cast<int>(str.size()), seed_, &hash);
+        return hash;
+    }
 
-        // TODO avoid lock there
-        std::lock_guard<std::mutex> lock(lock_);
-        HashIdMap::iterator hashLookupResult = map_.find(hash);
-        if (hashLookupResult != map_.end()) {
-            for (std::uint32_t id : hashLookupResult->second) {
-                std::string data;
-                readString(id, data);
-                if (str == data)
-                    return id;
+    /// Reads all strings from files into memory.
+    void load()
+    {
+        std::vector<char> data((std::istreambuf_iterator<char>(dataFile_)), std::istreambuf_iterator<char>());
+        dataFile_.clear();
+        dataSize_ = static_cast<std::uint32_t>(data.size());
+        // NOTE guarantees that the last string is null terminated.
+        data.push_back('\0');
+
+        std::uint32_t count = static_cast<std::uint32_t>(indexFile_.tellg() / (sizeof(std::uint32_t) * 2));
+        indexFile_.seekg(0, ios::beg);
+        for (std::uint32_t i = 0; i < count; ++i) {
+            std::uint32_t hash, offset;
+            indexFile_.read(reinterpret_cast<char*>(&hash), sizeof(hash));
+            indexFile_.read(reinterpret_cast<char*>(&offset), sizeof(offset));
+
+            const char* str = offset < dataSize_ ? data.data() + offset : "";
+            add(str, static_cast<std::uint32_t>(std::strlen(str)), hash);
+        }
+    }
+
+    /// Searches for string without locking.
+    bool find(const std::string& str, std::uint32_t hash, std::uint32_t& id) const
+    {
+        const HashIndex* index = index_.load(std::memory_order_acquire);
+        for (std::uint32_t i = hash & index->mask;; i = (i + 1) & index->mask) {
+            std::uint32_t slot = index->slots[i].load(std::memory_order_acquire);
+            if (slot == 0)
+                return false;
+
+            const Entry& entry = getEntry(slot - 1);
+            if (entry.hash == hash && entry.size == str.size() &&
+                std::memcmp(entry.data, str.c_str(), entry.size) == 0) {
+                id = slot - 1;
+                return true;
             }
         }
+    }
 
-        writeString(hash, str);
-        return nextId_++;
+    /// Adds string to memory structures. Should be called under lock.
+    std::uint32_t add(const char* str, std::uint32_t size, std::uint32_t hash)
+    {
+        std::uint32_t id = count_.load(std::memory_order_relaxed);
+
+        Entry& entry = allocateEntry(id);
+        entry.data = arena_.append(str, size);
+        entry.size = size;
+        entry.hash = hash;
+        entry.number = parseNumber(entry.data, size);
+
+        // NOTE entry should be visible before index slot.
+        count_.store(id + 1, std::memory_order_release);
+
+        HashIndex* index = index_.load(std::memory_order_relaxed);
+        if ((id + 1) * 2 > index->capacity())
+            index = grow(*index);
+        else
+            insert(*index, id, hash);
+
+        return id;
     }
 
-    std::string getString(std::uint32_t id)
+    /// Creates twice bigger index with all existing ids and publishes it.
+    /// NOTE old index is kept alive as readers may still use it.
+    HashIndex* grow(const HashIndex& old)
     {
-        std::string str;
-        // TODO avoid lock there
-        std::lock_guard<std::mutex> lock(lock_);
-        readString(id, str);
-        return str;
+        indices_.push_back(utymap::utils::make_unique<HashIndex>(old.capacity() * 2));
+        HashIndex* index = indices_.back().get();
+
+        std::uint32_t count = count_.load(std::memory_order_relaxed);
+        for (std::uint32_t id = 0; id < count; ++id)
+            insert(*index, id, getEntry(id).hash);
+
+        index_.store(index, std::memory_order_release);
+        return index;
     }
 
-private:
+    static void insert(HashIndex& index, std::uint32_t id, std::uint32_t hash)
+    {
+        std::uint32_t i = hash & index.mask;
+        while (index.slots[i].load(std::memory_order_relaxed) != 0)
+            i = (i + 1) & index.mask;
+        index.slots[i].store(id + 1, std::memory_order_release);
+    }
 
-    /// Reads string by id.
-    void readString(std::uint32_t id, std::string& data)
+    /// Gets segment and offset inside it for given id.
+    static void getLocation(std::uint32_t id, std::size_t& segment, std::uint32_t& offset)
     {
-        if (id < offsets_.size()) {
-            std::uint32_t offset = offsets_[id];
-            std::string::size_type size = id + 1 < nextId_ ? offsets_[id] : 8;
-            data.reserve(size);
+        std::uint64_t position = static_cast<std::uint64_t>(id) + FirstSegmentSize;
+        segment = 0;
+        while ((position >> (segment + 1)) >= FirstSegmentSize)
+            ++segment;
+        offset = static_cast<std::uint32_t>(position - (static_cast<std::uint64_t>(FirstSegmentSize) << segment));
+    }
 
-            dataFile_.seekg(offset, ios::beg);
-            std::getline(dataFile_, data, '\0');
+    const Entry& getEntry(std::uint32_t id) const
+    {
+        std::size_t segment;
+        std::uint32_t offset;
+        getLocation(id, segment, offset);
+        return segments_[segment].load(std::memory_order_acquire)[offset];
+    }
+
+    Entry& allocateEntry(std::uint32_t id)
+    {
+        std::size_t segment;
+        std::uint32_t offset;
+        getLocation(id, segment, offset);
+
+        Entry* entries = segments_[segment].load(std::memory_order_relaxed);
+        if (entries == nullptr) {
+            entries = new Entry[static_cast<std::size_t>(FirstSegmentSize) << segment];
+            segments_[segment].store(entries, std::memory_order_release);
         }
+        return entries[offset];
     }
 
-    /// Writes string to index.
+    /// Writes string to files. Should be called under lock.
     void writeString(std::uint32_t hash, const std::string& data)
     {
-        // get offset as file size
-        dataFile_.seekg(0, ios::end);
-        std::uint32_t offset = static_cast<std::uint32_t>(dataFile_.tellg());
+        std::uint32_t offset = dataSize_;
 
         // write string
-        dataFile_.seekp(0, ios::end);
-        dataFile_ << data.c_str() << '\0';
+        dataFile_.write(data.c_str(), data.size() + 1);
+        dataSize_ += static_cast<std::uint32_t>(data.size() + 1);
 
         // write index entry
-        indexFile_.seekp(0, ios::end);
         indexFile_.write(reinterpret_cast<char*>(&hash), sizeof(hash));
         indexFile_.write(reinterpret_cast<char*>(&offset), sizeof(offset));
-
-        map_[hash].push_back(nextId_);
-        offsets_.push_back(offset);
     }
 
     std::fstream indexFile_;
     std::fstream dataFile_;
     std::uint32_t seed_;
-    std::uint32_t nextId_;
+    std::uint32_t dataSize_;
+
+    std::atomic<std::uint32_t> count_;
+    std::atomic<Entry*> segments_[MaxSegments];
+    StringArena arena_;
 
-    /// TODO think about better data structure alternatives
-    HashIdMap map_;
-    std::vector<std::uint32_t> offsets_;
+    std::vector<std::unique_ptr<HashIndex>> indices_;
+    std::atomic<HashIndex*> index_;
 
     std::mutex lock_;
 };
@@ -134,3 +334,8 @@ std::string StringTable::getString(std::uint32_t id) const
 {
     return pimpl_->getString(id);
 }
+
+double StringTable::getNumber(std::uint32_t id) const
+{
+    return pimpl_->getNumber(id);
+}
@@ -8,9 +8,11 @@
 namespace utymap { namespace index {
 
 /// Provides the way to maintain strings.
-/// Index file consists of id-offset pairs where id - string id,
-/// offset - first character of the string inside data file.
-/// data file contains list of null terminated strings.
+/// Index file consists of hash-offset pairs where hash - string hash,
+/// offset - first character of the string inside data file; position of
+/// pair is string id. Data file contains list of null terminated strings.
+/// All strings are kept in memory: files are used only for persistence.
+/// Methods are thread safe, lookup of existing strings does not lock.
 class StringTable final
 {
 public:
@@ -29,6 +31,10 @@ public:
     /// Gets original string by id.
     std::string getString(std::uint32_t id) const;
 
+    /// Gets numeric value of string with given id parsed once on insertion.
+    /// Returns zero if string is not a number.
+    double getNumber(std::uint32_t id) const;
+
 private:
     class StringTableImpl;
     std::unique_ptr<StringTableImpl> pimpl_;
@@ -3,6 +3,7 @@
 
 #include "mapcss/Color.hpp"
 
+#include <array>
 #include <cstdint>
 #include <vector>
 #include <utility>
@@ -17,22 +18,32 @@ public:
     /// gradient data: first - time, second - color.
     typedef std::vector<std::pair<double, utymap::mapcss::Color>> GradientData;
 
-    ColorGradient() {}
+    /// Amount of colors precomputed for evenly distributed times.
+    static const std::size_t LookupSize = 256;
+
+    /// Lookup table type: colors in rgba format.
+    typedef std::array<std::uint32_t, LookupSize> LookupTable;
+
+    ColorGradient() : colors_(), lookup_() {}
 
     explicit ColorGradient(const GradientData& colors) :
-        colors_(colors)
+        colors_(colors), lookup_()
     {
+        for (std::size_t i = 0; i < LookupSize; ++i)
+            lookup_[i] = evaluate(static_cast<double>(i) / (LookupSize - 1));
     }
 
     ColorGradient(ColorGradient&& other) :
-        colors_(std::move(other.colors_))
+        colors_(std::move(other.colors_)), lookup_(other.lookup_)
     {
     }
 
     ColorGradient& operator=(ColorGradient&& other)
     {
-        if (this != &other)
+        if (this != &other) {
             colors_ = std::move(other.colors_);
+            lookup_ = other.lookup_;
+        }
 
         return *this;
     }
@@ -56,6 +67,25 @@ public:
         return interpolate(pairA.second, pairB.second, mu);
     }
 
+    /// Returns precomputed color for given time in [0, 1] range.
+    /// NOTE time is quantized, so color may slightly differ from evaluated one.
+    std::uint32_t lookup(double time) const
+    {
+        return lookup_[getLookupIndex(time)];
+    }
+
+    /// Returns lookup table with precomputed colors.
+    const LookupTable& lookupTable() const { return lookup_; }
+
+    /// Returns index in lookup table for given time clamping it to [0, 1] range.
+    static std::size_t getLookupIndex(double time)
+    {
+        double position = time * (LookupSize - 1) + 0.5;
+        return position <= 0
+            ? 0
+            : (position >= LookupSize - 1 ? LookupSize - 1 : static_cast<std::size_t>(position));
+    }
+
     /// Returns true if there is no color specified.
     bool empty() const { return colors_.empty(); }
 
@@ -70,6 +100,7 @@ private:
     }
 
     GradientData colors_;
+    LookupTable lookup_;
 };
 
 }}
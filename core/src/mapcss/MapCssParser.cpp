@@ -214,6 +214,7 @@ private:
 
     void readImport(const std::string& url) const
     {
+        stylesheet.sources.push_back(directory + url);
         std::ifstream importFile(directory + url);
         std::string content((std::istreambuf_iterator<char>(importFile)), std::istreambuf_iterator<char>());
         // NOTE indirected recursion: caller must ensure that there is no recursive import.
@@ -276,6 +277,7 @@ private:
         std::ifstream file(directory + fileName);
         if (!file.good())
             throw utymap::MapCssException(std::string("Cannot find:") + directory + fileName);
+        stylesheet.sources.push_back(directory + fileName);
         return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
     }
 
@@ -96,56 +96,70 @@ struct Style final
                : declaration.value();
     }
 
+    /// Gets color gradient which was resolved on stylesheet load or nullptr.
+    const ColorGradient* getGradient(const std::string& key) const
+    {
+        auto it = declarations_.find(stringTable_.getId(key));
+        return it != declarations_.end() ? it->second->gradient() : nullptr;
+    }
+
     /// Gets double value or zero.
     double getValue(const std::string& key) const
     {
-        return getValue(key, 1);
+        return getValue(stringTable_.getId(key), 1);
     }
 
     /// Gets double value or zero.
     /// Relative size is used when dimension is specified
     double getValue(const std::string& key, double relativeSize) const
     {
-        return getValue(key, relativeSize, BoundingBox());
+        return getValue(stringTable_.getId(key), relativeSize);
     }
 
     /// Gets double value or zero.
     /// Bounding box is used when dimension is specified
     double getValue(const std::string& key, const BoundingBox& bbox) const
     {
-        return getValue(key, bbox.height(), bbox);
+        return getValue(stringTable_.getId(key), bbox);
+    }
+
+    /// Gets double value or zero using pre-interned key.
+    /// Relative size is used when dimension is specified
+    double getValue(std::uint32_t keyId, double relativeSize = 1) const
+    {
+        return getValue(keyId, relativeSize, BoundingBox());
+    }
+
+    /// Gets double value or zero using pre-interned key.
+    /// Bounding box is used when dimension is specified
+    double getValue(std::uint32_t keyId, const BoundingBox& bbox) const
+    {
+        return getValue(keyId, bbox.height(), bbox);
     }
 
 private:
 
     /// Gets double value or zero.
     /// Bounding box is used when dimension is specified
-    double getValue(const std::string& key, double relativeSize, const BoundingBox& bbox) const
+    double getValue(std::uint32_t keyId, double relativeSize, const BoundingBox& bbox) const
     {
-        std::uint32_t keyId = stringTable_.getId(key);
-
-        if (!has(keyId))
+        auto it = declarations_.find(keyId);
+        if (it == declarations_.end())
             return 0;
 
-        const auto& declaration = get(keyId);
-        const auto& rawValue = declaration.value();
-        char dimen = rawValue[rawValue.size() - 1];
-
-        if (dimen == 'm') {
-            double value = utymap::utils::parseDouble(rawValue.substr(0, rawValue.size() - 1));
-            return bbox.isValid()
-                ? utymap::utils::GeoUtils::getOffset(bbox.center(), value)
-                : value;
-        }
-
-        if (dimen == '%') {
-            double value = utymap::utils::parseDouble(rawValue.substr(0, rawValue.size() - 1));
-            return relativeSize * value * 0.01;
+        const auto& declaration = *it->second;
+        switch (declaration.dimension()) {
+            case StyleDeclaration::Dimension::Meters:
+                return bbox.isValid()
+                    ? utymap::utils::GeoUtils::getOffset(bbox.center(), declaration.number())
+                    : declaration.number();
+            case StyleDeclaration::Dimension::Percent:
+                return relativeSize * declaration.number() * 0.01;
+            default:
+                return declaration.isEval()
+                    ? declaration.evaluate<double>(tags_, stringTable_)
+                    : declaration.number();
         }
-
-        return declaration.isEval()
-            ? declaration.evaluate<double>(tags_, stringTable_)
-            : utymap::utils::parseDouble(rawValue);
     }
 
     utymap::index::StringTable& stringTable_;
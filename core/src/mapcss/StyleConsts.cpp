@@ -92,6 +92,12 @@ const std::string& StyleConsts::GridCellSize()
     return value;
 }
 
+const std::string& StyleConsts::MeshTypeKey()
+{
+    static const std::string value = "mesh-type";
+    return value;
+}
+
 const std::string& StyleConsts::TerrainLayerKey()
 {
     static const std::string value = "terrain-layer";
@@ -28,6 +28,7 @@ struct StyleConsts final {
     static const std::string& MeshNameKey();
     static const std::string& MeshExtrasKey();
     static const std::string& GridCellSize();
+    static const std::string& MeshTypeKey();
 
     static const std::string& TerrainLayerKey();
     
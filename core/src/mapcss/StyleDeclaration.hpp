@@ -4,7 +4,9 @@
 #include "Exceptions.hpp"
 #include "entities/Element.hpp"
 #include "index/StringTable.hpp"
+#include "mapcss/ColorGradient.hpp"
 #include "mapcss/StyleEvaluator.hpp"
+#include "utils/CoreUtils.hpp"
 #include "utils/ElementUtils.hpp"
 
 #include <cstdint>
@@ -15,18 +17,40 @@
 namespace utymap { namespace mapcss {
 
 /// Represents style declaration which support evaluation.
+/// Numeric value and its dimension are parsed once on creation.
 struct StyleDeclaration final
 {
+    /// Specifies dimension of numeric value.
+    enum class Dimension { None, Meters, Percent };
+
     StyleDeclaration(std::uint32_t key, const std::string& value) :
         key_(key),
         value_(value),
-        tree_(StyleEvaluator::parse(value))
+        tree_(StyleEvaluator::parse(value)),
+        program_(),
+        dimension_(parseDimension(value)),
+        number_(parseNumber(value, dimension_)),
+        gradient_(nullptr)
+    {
+    }
+
+    /// Creates declaration which expression is compiled once with tag keys resolved by string table.
+    /// Gradient is color gradient parsed from value if value represents gradient.
+    StyleDeclaration(std::uint32_t key, const std::string& value, utymap::index::StringTable& stringTable,
+                     const ColorGradient* gradient = nullptr) :
+        StyleDeclaration(key, value)
     {
+        gradient_ = gradient;
+        if (tree_ != nullptr) {
+            program_ = utymap::utils::make_unique<StyleEvaluator::Program>(StyleEvaluator::compile(*tree_, stringTable));
+            tree_.reset();
+        }
     }
 
     ~StyleDeclaration() {};
     StyleDeclaration(StyleDeclaration&& other) : 
-        key_(other.key_), value_(other.value_), tree_(std::move(other.tree_))
+        key_(other.key_), value_(other.value_), tree_(std::move(other.tree_)), program_(std::move(other.program_)),
+        dimension_(other.dimension_), number_(other.number_), gradient_(other.gradient_)
     {
     }
 
@@ -40,8 +64,17 @@ struct StyleDeclaration final
     /// Gets declaration value.
     const std::string& value() const { return value_; };
 
+    /// Gets dimension of numeric value.
+    Dimension dimension() const { return dimension_; }
+
+    /// Gets numeric value without dimension suffix or zero if value is not a number.
+    double number() const { return number_; }
+
+    /// Gets color gradient resolved on stylesheet load or nullptr.
+    const ColorGradient* gradient() const { return gradient_; }
+
     /// Gets true if declaration should be evaluated
-    bool isEval() const { return tree_ != nullptr; }
+    bool isEval() const { return program_ != nullptr || tree_ != nullptr; }
 
     /// Evaluates expression using tags
     template <typename T>
@@ -51,14 +84,40 @@ struct StyleDeclaration final
         if (!isEval())
             throw utymap::MapCssException("Cannot evaluate raw value.");
 
-        return StyleEvaluator::evaluate<T>(*tree_, tags, stringTable);
+        // NOTE declaration created without string table is compiled on every evaluation.
+        return program_ != nullptr
+            ? StyleEvaluator::evaluate<T>(*program_, tags, stringTable)
+            : StyleEvaluator::evaluate<T>(StyleEvaluator::compile(*tree_, stringTable), tags, stringTable);
     }
 
 private:
 
+    static Dimension parseDimension(const std::string& value)
+    {
+        if (value.empty())
+            return Dimension::None;
+
+        switch (value.back()) {
+            case 'm': return Dimension::Meters;
+            case '%': return Dimension::Percent;
+            default: return Dimension::None;
+        }
+    }
+
+    static double parseNumber(const std::string& value, Dimension dimension)
+    {
+        return dimension == Dimension::None
+            ? utymap::utils::parseDouble(value)
+            : utymap::utils::parseDouble(value.substr(0, value.size() - 1));
+    }
+
     std::uint32_t key_;
     std::string value_;
     std::unique_ptr<StyleEvaluator::Tree> tree_;
+    std::unique_ptr<StyleEvaluator::Program> program_;
+    Dimension dimension_;
+    double number_;
+    const ColorGradient* gradient_;
 };
 
 }}
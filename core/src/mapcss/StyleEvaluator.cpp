@@ -1,9 +1,15 @@
 #include "mapcss/StyleEvaluator.hpp"
+#include "Exceptions.hpp"
 #include "utils/CoreUtils.hpp"
+#include "utils/ElementUtils.hpp"
 
 #include <boost/config/warning_disable.hpp>
 #include <boost/spirit/include/qi.hpp>
 #include <boost/fusion/include/adapt_struct.hpp>
+#include <boost/variant/apply_visitor.hpp>
+
+#include <algorithm>
+#include <limits>
 
 using namespace utymap::entities;
 using namespace utymap::index;
@@ -16,6 +22,12 @@ namespace {
     typedef StyleEvaluator::Tree Tree;
     typedef StyleEvaluator::Operation Operation;
     typedef StyleEvaluator::Operand Operand;
+    typedef StyleEvaluator::OpCode OpCode;
+    typedef StyleEvaluator::Instruction Instruction;
+    typedef StyleEvaluator::Program Program;
+
+    /// Size of stack allocated on call stack during evaluation.
+    const std::size_t LocalStackSize = 16;
 
     namespace qi = boost::spirit::qi;
     namespace ascii = boost::spirit::ascii;
@@ -55,6 +67,87 @@ namespace {
         qi::rule<Iterator, Tree(), ascii::space_type> term;
         qi::rule<Iterator, Operand(), ascii::space_type> factor;
     };
+
+    /// Compiles AST into postfix instructions tracking stack depth.
+    struct Compiler : public boost::static_visitor<void>
+    {
+        Compiler(Program& p, StringTable& st) :
+            program(p), stringTable(st), depth(0)
+        {
+        }
+
+        void operator()(Nil) { emit(OpCode::Number, 0, 0); }
+
+        void operator()(double n) { emit(OpCode::Number, 0, n); }
+
+        void operator()(const std::string& tagKey) { emit(OpCode::Tag, stringTable.getId(tagKey), 0); }
+
+        void operator()(const Signed& s)
+        {
+            boost::apply_visitor(*this, s.operand);
+            switch (s.sign) {
+                case '-': emit(OpCode::Negate, 0, 0); break;
+                case '+': break;
+                default: throw utymap::MapCssException(std::string("Unsupported sign: ") + s.sign);
+            }
+        }
+
+        void operator()(const Tree& tree)
+        {
+            boost::apply_visitor(*this, tree.first);
+            for (const Operation& oper : tree.rest) {
+                boost::apply_visitor(*this, oper.operand);
+                switch (oper.operator_) {
+                    case '+': emit(OpCode::Add, 0, 0); break;
+                    case '-': emit(OpCode::Subtract, 0, 0); break;
+                    case '*': emit(OpCode::Multiply, 0, 0); break;
+                    case '/': emit(OpCode::Divide, 0, 0); break;
+                    default: throw utymap::MapCssException(std::string("Unsupported operator: ") + oper.operator_);
+                }
+            }
+        }
+
+    private:
+        void emit(OpCode code, std::uint32_t key, double number)
+        {
+            program.instructions.push_back(Instruction{ code, key, number });
+            switch (code) {
+                case OpCode::Number:
+                case OpCode::Tag:
+                    program.stackSize = std::max(program.stackSize, ++depth);
+                    break;
+                case OpCode::Negate:
+                    break;
+                default:
+                    --depth;
+            }
+        }
+
+        Program& program;
+        StringTable& stringTable;
+        std::size_t depth;
+    };
+
+    /// Finds tag key which is used as string value: the first operand of expression.
+    struct StringKeyFinder : public boost::static_visitor<const std::string*>
+    {
+        const std::string* operator()(const std::string& tagKey) const { return &tagKey; }
+        const std::string* operator()(const Tree& tree) const { return boost::apply_visitor(*this, tree.first); }
+
+        template <typename T>
+        const std::string* operator()(const T&) const { return nullptr; }
+    };
+
+    /// Gets numeric tag value using value parsed by string table once on insertion.
+    double getTagNumber(std::uint32_t key, const std::vector<Tag>& tags, const StringTable& stringTable)
+    {
+        return stringTable.getNumber(utymap::utils::getTagValue(key, tags, std::numeric_limits<std::uint32_t>::max(),
+            [&](const std::uint32_t v) {
+                if (v == std::numeric_limits<std::uint32_t>::max())
+                    throw std::domain_error("Cannot find tag:" + stringTable.getString(key));
+                return v;
+            }));
+    }
 }
 
 BOOST_FUSION_ADAPT_STRUCT(
@@ -90,4 +183,59 @@ std::unique_ptr<Tree> StyleEvaluator::parse(const std::string& expression)
         tree.reset();
     
     return tree;
-}
\ No newline at end of file
+}
+
+Program StyleEvaluator::compile(const Tree& tree, StringTable& stringTable)
+{
+    Program program;
+    program.stackSize = 0;
+
+    Compiler compiler(program, stringTable);
+    compiler(tree);
+
+    const std::string* stringKey = StringKeyFinder()(tree);
+    program.hasStringKey = stringKey != nullptr;
+    program.stringKey = program.hasStringKey ? stringTable.getId(*stringKey) : 0;
+
+    return program;
+}
+
+double StyleEvaluator::evaluate(const Program& program,
+                                const std::vector<Tag>& tags,
+                                const StringTable& stringTable,
+                                double*)
+{
+    double local[LocalStackSize];
+    std::vector<double> heap;
+    double* stack = local;
+    if (program.stackSize > LocalStackSize) {
+        heap.resize(program.stackSize);
+        stack = heap.data();
+    }
+
+    std::size_t top = 0;
+    for (const Instruction& instruction : program.instructions) {
+        switch (instruction.code) {
+            case OpCode::Number: stack[top++] = instruction.number; break;
+            case OpCode::Tag: stack[top++] = getTagNumber(instruction.key, tags, stringTable); break;
+            case OpCode::Add: --top; stack[top - 1] += stack[top]; break;
+            case OpCode::Subtract: --top; stack[top - 1] -= stack[top]; break;
+            case OpCode::Multiply: --top; stack[top - 1] *= stack[top]; break;
+            case OpCode::Divide: --top; stack[top - 1] /= stack[top]; break;
+            case OpCode::Negate: stack[top - 1] = -stack[top - 1]; break;
+        }
+    }
+
+    return top > 0 ? stack[top - 1] : 0;
+}
+
+std::string StyleEvaluator::evaluate(const Program& program,
+                                     const std::vector<Tag>& tags,
+                                     const StringTable& stringTable,
+                                     std::string*)
+{
+    if (!program.hasStringKey)
+        throw std::domain_error("Evaluator: unsupported operation.");
+
+    return utymap::utils::getTagValue(program.stringKey, tags, stringTable);
+}
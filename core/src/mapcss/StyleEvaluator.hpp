@@ -3,16 +3,14 @@
 
 #include "entities/Element.hpp"
 #include "index/StringTable.hpp"
-#include "utils/CoreUtils.hpp"
-#include "utils/ElementUtils.hpp"
 
 #include <boost/variant/recursive_variant.hpp>
-#include <boost/variant/apply_visitor.hpp>
 
 #include <cstdint>
 #include <string>
 #include <list>
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 namespace utymap { namespace mapcss {
@@ -20,7 +18,7 @@ namespace utymap { namespace mapcss {
 /// Represents style declaration which support evaluation.
 struct StyleEvaluator final
 {
-    /// NOTE has to put these declarations here due to evaluate function implementation
+    /// AST produced by expression parser.
     struct Nil {};
     struct Signed;
     struct Tree;
@@ -44,114 +42,62 @@ struct StyleEvaluator final
         std::list<Operation> rest;
     };
 
-    StyleEvaluator() = delete;
-
-    /// Parses expression into AST.
-    static std::unique_ptr<Tree> parse(const std::string& expression);
+    /// Specifies operation of compiled expression instruction.
+    enum class OpCode : std::uint8_t { Number, Tag, Add, Subtract, Multiply, Divide, Negate };
 
-    /// Evaluates expression using tags.
-    template <typename T>
-    static T evaluate(const Tree& tree,
-                      const std::vector<utymap::entities::Tag>& tags,
-                      utymap::index::StringTable& stringTable)
+    /// Represents single instruction of compiled expression.
+    struct Instruction
     {
-        typedef typename std::conditional<std::is_same<T, std::string>::value, StringEvaluator, DoubleEvaluator>::type EvaluatorType;
-        return EvaluatorType(tags, stringTable)(tree);
-    }
-
-private:
-
-    /// Specifies default AST evaluator behaviour.
-    template <typename T>
-    struct Evaluator
-    {
-        typedef T result_type;
-
-        Evaluator(const std::vector<utymap::entities::Tag>& tags,
-                  utymap::index::StringTable& stringTable) :
-            tags_(tags), stringTable_(stringTable)  { }
-
-    protected:
-        static std::string throwException() { throw std::domain_error("Evaluator: unsupported operation."); }
-
-        const std::vector<utymap::entities::Tag>& tags_;
-        utymap::index::StringTable& stringTable_;
+        OpCode code;
+        /// Tag key id used by Tag instruction.
+        std::uint32_t key;
+        /// Value used by Number instruction.
+        double number;
     };
 
-    /// Evaluates double from AST.
-    struct DoubleEvaluator : public Evaluator<double>
+    /// Represents expression compiled into flat postfix instruction array with tag keys resolved to ids.
+    struct Program
     {
-        DoubleEvaluator(const std::vector<utymap::entities::Tag>& tags,
-                        utymap::index::StringTable& stringTable) :
-            Evaluator(tags, stringTable) { }
-
-        double operator()(Nil) const { return 0; }
-        double operator()(double n) const { return n; }
-
-        double operator()(const Operation& o, double lhs) const
-        {
-            double rhs = boost::apply_visitor(*this, o.operand);
-            switch (o.operator_) {
-                case '+': return lhs + rhs;
-                case '-': return lhs - rhs;
-                case '*': return lhs * rhs;
-                case '/': return lhs / rhs;
-                default: return 0;
-            }
-        }
-
-        double operator()(const std::string& tagKey) const
-        {
-            auto keyId = stringTable_.getId(tagKey);
-            return utymap::utils::parseDouble(utymap::utils::getTagValue(keyId, tags_, stringTable_));
-        }
-
-        double operator()(const Signed& s) const
-        {
-            double rhs = boost::apply_visitor(*this, s.operand);
-            switch (s.sign) {
-                case '-': return -rhs;
-                case '+': return +rhs;
-                default: return 0;
-            }
-        }
-
-        double operator()(const Tree& tree) const
-        {
-            double state = boost::apply_visitor(*this, tree.first);
-            for (const Operation& oper : tree.rest)
-                state = (*this)(oper, state);
-            return state;
-        }
+        std::vector<Instruction> instructions;
+        /// Max amount of values on stack during evaluation.
+        std::size_t stackSize;
+        /// Tag key id used by string evaluation.
+        std::uint32_t stringKey;
+        /// True if expression can be evaluated as string.
+        bool hasStringKey;
     };
 
-    /// Evaluates string from AST.
-    struct StringEvaluator : public Evaluator<std::string>
-    {
-        StringEvaluator(const std::vector<utymap::entities::Tag>& tags,
-            utymap::index::StringTable& stringTable)
-            : Evaluator(tags, stringTable) { }
-
-        std::string operator()(Nil) const { return throwException(); }
-        std::string operator()(double n) const { return throwException(); }
+    StyleEvaluator() = delete;
 
-        std::string operator()(const Operation& o, double lhs) const { return throwException(); }
+    /// Parses expression into AST.
+    static std::unique_ptr<Tree> parse(const std::string& expression);
 
-        std::string operator()(const std::string& tagKey) const
-        {
-            return utymap::utils::getTagValue(stringTable_.getId(tagKey), tags_, stringTable_);
-        }
+    /// Compiles AST into program resolving tag keys using string table.
+    static Program compile(const Tree& tree, utymap::index::StringTable& stringTable);
 
-        std::string operator()(const Signed& s) const { return throwException(); }
+    /// Evaluates compiled expression using tags.
+    template <typename T>
+    static T evaluate(const Program& program,
+                      const std::vector<utymap::entities::Tag>& tags,
+                      const utymap::index::StringTable& stringTable)
+    {
+        typedef typename std::conditional<std::is_same<T, std::string>::value, std::string, double>::type ResultType;
+        return evaluate(program, tags, stringTable, static_cast<ResultType*>(nullptr));
+    }
 
-        std::string operator()(const Tree& tree) const
-        {
-            return boost::apply_visitor(*this, tree.first);
-        }
-    };
+private:
 
-    std::string value_;
-    std::unique_ptr<Tree> tree_;
+    /// Evaluates double by running instructions on value stack.
+    static double evaluate(const Program& program,
+                           const std::vector<utymap::entities::Tag>& tags,
+                           const utymap::index::StringTable& stringTable,
+                           double*);
+
+    /// Evaluates string which is only supported for single tag expression.
+    static std::string evaluate(const Program& program,
+                                const std::vector<utymap::entities::Tag>& tags,
+                                const utymap::index::StringTable& stringTable,
+                                std::string*);
 };
 
 } }
@@ -1,3 +1,4 @@
+#include "hashing/MurmurHash3.h"
 #include "entities/ElementVisitor.hpp"
 #include "entities/Node.hpp"
 #include "entities/Way.hpp"
@@ -8,8 +9,11 @@
 #include "utils/CoreUtils.hpp"
 #include "utils/GradientUtils.hpp"
 
+#include <array>
 #include <climits>
 #include <functional>
+#include <list>
+#include <memory>
 #include <mutex>
 
 using namespace utymap::entities;
@@ -28,6 +32,8 @@ struct ConditionType final
     uint32_t key;
     uint32_t value;
     OpType type;
+    /// Value parsed as number: used by Less and Greater operations.
+    double number;
 };
 
 struct ConditionFilter final
@@ -36,8 +42,65 @@ struct ConditionFilter final
     std::vector<std::shared_ptr<const StyleDeclaration>> declarations;
 };
 
+/// Indexes condition filters of one level of details by tags which they require, so only
+/// candidate filters are checked for given element instead of all of them.
+/// NOTE every condition requires its key to be present (see StyleBuilder::matchTags), so each
+/// filter is registered under one of its conditions: equality is preferred as the most selective.
+struct ConditionFilterIndex final
+{
+    /// Filters in order of definition.
+    std::vector<ConditionFilter> filters;
+
+    void add(const ConditionFilter& filter)
+    {
+        auto index = static_cast<std::uint32_t>(filters.size());
+        filters.push_back(filter);
+
+        if (filter.conditions.empty()) {
+            unconditional_.push_back(index);
+            return;
+        }
+
+        auto condition = std::find_if(filter.conditions.begin(), filter.conditions.end(),
+            [](const ConditionType& c) { return c.type == OpType::Equals; });
+        if (condition != filter.conditions.end())
+            byTag_[getTagKey(condition->key, condition->value)].push_back(index);
+        else
+            byKey_[filter.conditions.front().key].push_back(index);
+    }
+
+    /// Collects indices of filters which might match given tags in order of definition.
+    void getCandidates(const std::vector<Tag>& tags, std::vector<std::uint32_t>& candidates) const
+    {
+        candidates.assign(unconditional_.begin(), unconditional_.end());
+        for (const auto& tag : tags) {
+            auto byKey = byKey_.find(tag.key);
+            if (byKey != byKey_.end())
+                candidates.insert(candidates.end(), byKey->second.begin(), byKey->second.end());
+
+            auto byTag = byTag_.find(getTagKey(tag.key, tag.value));
+            if (byTag != byTag_.end())
+                candidates.insert(candidates.end(), byTag->second.begin(), byTag->second.end());
+        }
+
+        // NOTE order matters as declarations of later rules override earlier ones.
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    }
+
+private:
+    static std::uint64_t getTagKey(std::uint32_t key, std::uint32_t value)
+    {
+        return static_cast<std::uint64_t>(key) << 32 | value;
+    }
+
+    std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> byTag_;
+    std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> byKey_;
+    std::vector<std::uint32_t> unconditional_;
+};
+
 /// Key: level of details, value: filters for specific element type.
-typedef std::unordered_map<int, std::vector<ConditionFilter>> ConditionFilterMap;
+typedef std::unordered_map<int, ConditionFilterIndex> ConditionFilterMap;
 typedef std::unordered_map<std::uint64_t, std::vector<std::shared_ptr<const StyleDeclaration>>> IdentifierFilter;
 typedef std::unordered_map<int, IdentifierFilter> IdentifierFilterMap;
 
@@ -51,29 +114,259 @@ struct FilterCollection final
     IdentifierFilterMap elements;
 };
 
+/// Keeps color gradients. Gradients used by stylesheet are added to index which is immutable
+/// once provider is built, so it is read without synchronization. Gradient keys computed at
+/// runtime are common, so gradients parsed on miss are kept in map split into shards by key
+/// hash: each shard has own lock and owns its gradients, so insertion does not copy anything.
+class GradientCache final
+{
+    typedef std::unordered_map<std::string, const ColorGradient*> GradientIndex;
+
+    struct Shard
+    {
+        std::vector<std::unique_ptr<const ColorGradient>> gradients;
+        GradientIndex index;
+        std::mutex lock;
+    };
+
+    /// Amount of runtime shards.
+    static const std::size_t ShardCount = 16;
+
+public:
+    GradientCache() : gradients_(), index_(), shards_()
+    {
+    }
+
+    GradientCache(const GradientCache&) = delete;
+    GradientCache& operator=(const GradientCache&) = delete;
+
+    /// Adds gradient for given key while provider is built. Returns nullptr if gradient is invalid.
+    /// NOTE not thread safe: should not be called once provider is built.
+    const ColorGradient* add(const std::string& key)
+    {
+        const ColorGradient* gradient = find(index_, key);
+        if (gradient != nullptr)
+            return gradient;
+
+        gradient = parse(key, gradients_);
+        if (gradient != nullptr)
+            index_.emplace(key, gradient);
+        return gradient;
+    }
+
+    /// Returns gradient for given key parsing it on miss. Returns nullptr if gradient is invalid.
+    const ColorGradient* get(const std::string& key)
+    {
+        const ColorGradient* gradient = find(index_, key);
+        if (gradient != nullptr)
+            return gradient;
+
+        Shard& shard = shards_[std::hash<std::string>()(key) % ShardCount];
+        std::lock_guard<std::mutex> lock(shard.lock);
+        gradient = find(shard.index, key);
+        if (gradient != nullptr)
+            return gradient;
+
+        gradient = parse(key, shard.gradients);
+        if (gradient != nullptr)
+            shard.index.emplace(key, gradient);
+        return gradient;
+    }
+
+private:
+    static const ColorGradient* find(const GradientIndex& index, const std::string& key)
+    {
+        auto it = index.find(key);
+        return it != index.end() ? it->second : nullptr;
+    }
+
+    static const ColorGradient* parse(const std::string& key,
+                                      std::vector<std::unique_ptr<const ColorGradient>>& gradients)
+    {
+        auto parsed = utymap::utils::GradientUtils::parseGradient(key);
+        if (parsed->empty())
+            return nullptr;
+
+        gradients.push_back(std::move(parsed));
+        return gradients.back().get();
+    }
+
+    /// Gradients of stylesheet.
+    std::vector<std::unique_ptr<const ColorGradient>> gradients_;
+    GradientIndex index_;
+    /// Gradients parsed on runtime miss.
+    std::array<Shard, ShardCount> shards_;
+};
+
+/// Element types used to distinguish cached styles.
+enum class ElementType : std::uint8_t { Node, Way, Area, Relation };
+
+/// Represents style resolved from condition rules.
+struct ResolvedStyle final
+{
+    bool canBuild;
+    std::vector<const StyleDeclaration*> declarations;
+};
+
+/// Keeps styles resolved for recently seen tag sets. Many elements share the same tags,
+/// so they share resolved style. Entries are split into shards by hash of the key, each shard
+/// has own lock and evicts its least recently used entries first.
+class StyleCache final
+{
+    struct Entry
+    {
+        std::uint32_t hash;
+        ElementType type;
+        int levelOfDetail;
+        std::vector<Tag> tags;
+        std::shared_ptr<const ResolvedStyle> style;
+    };
+
+    typedef std::list<Entry> EntryList;
+    typedef std::unordered_multimap<std::uint32_t, EntryList::iterator> EntryMap;
+
+    struct Shard
+    {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        EntryList list;
+        EntryMap map;
+        mutable std::mutex lock;
+    };
+
+    /// Amount of shards, must be power of two.
+    static const std::size_t ShardCount = 16;
+
+public:
+    explicit StyleCache(std::size_t capacity) :
+        capacity_(std::max<std::size_t>((capacity + ShardCount - 1) / ShardCount, 1))
+    {
+    }
+
+    /// Returns cached style or nullptr.
+    std::shared_ptr<const ResolvedStyle> get(ElementType type, int levelOfDetail, const std::vector<Tag>& tags)
+    {
+        std::uint32_t hash = getHash(type, levelOfDetail, tags);
+        Shard& shard = getShard(hash);
+
+        std::lock_guard<std::mutex> lock(shard.lock);
+        auto it = find(shard, hash, type, levelOfDetail, tags);
+        if (it == shard.map.end()) {
+            ++shard.misses;
+            return nullptr;
+        }
+
+        ++shard.hits;
+        shard.list.splice(shard.list.begin(), shard.list, it->second);
+        return it->second->style;
+    }
+
+    /// Puts style into cache evicting least recently used one of the shard if necessary.
+    void put(ElementType type, int levelOfDetail, const std::vector<Tag>& tags,
+             const std::shared_ptr<const ResolvedStyle>& style)
+    {
+        std::uint32_t hash = getHash(type, levelOfDetail, tags);
+        Shard& shard = getShard(hash);
+
+        std::lock_guard<std::mutex> lock(shard.lock);
+        // NOTE style might be resolved by another thread meanwhile.
+        if (find(shard, hash, type, levelOfDetail, tags) != shard.map.end())
+            return;
+
+        if (shard.map.size() >= capacity_)
+            erase(shard, shard.list.back());
+
+        shard.list.push_front(Entry { hash, type, levelOfDetail, tags, style });
+        shard.map.emplace(hash, shard.list.begin());
+    }
+
+    StyleProvider::CacheStatistics getStatistics() const
+    {
+        StyleProvider::CacheStatistics statistics { 0, 0, 0 };
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.lock);
+            statistics.hits += shard.hits;
+            statistics.misses += shard.misses;
+            statistics.entries += shard.map.size();
+        }
+        return statistics;
+    }
+
+private:
+    static std::uint32_t getHash(ElementType type, int levelOfDetail, const std::vector<Tag>& tags)
+    {
+        std::uint32_t seed = static_cast<std::uint32_t>(levelOfDetail) << 8 | static_cast<std::uint8_t>(type);
+        std::uint32_t hash;
+        MurmurHash3_x86_32(tags.data(), static_cast<int>(tags.size() * sizeof(Tag)), seed, &hash);
+        return hash;
+    }
+
+    static bool isEqual(const std::vector<Tag>& lhs, const std::vector<Tag>& rhs)
+    {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(),
+            [](const Tag& l, const Tag& r) { return l.key == r.key && l.value == r.value; });
+    }
+
+    /// NOTE high bits are used as low ones select bucket inside shard.
+    Shard& getShard(std::uint32_t hash)
+    {
+        return shards_[(hash >> 24) & (ShardCount - 1)];
+    }
+
+    static EntryMap::iterator find(Shard& shard, std::uint32_t hash, ElementType type, int levelOfDetail,
+                                   const std::vector<Tag>& tags)
+    {
+        auto range = shard.map.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            const Entry& entry = *it->second;
+            if (entry.type == type && entry.levelOfDetail == levelOfDetail && isEqual(entry.tags, tags))
+                return it;
+        }
+        return shard.map.end();
+    }
+
+    static void erase(Shard& shard, const Entry& entry)
+    {
+        auto range = shard.map.equal_range(entry.hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (&*it->second == &entry) {
+                shard.list.erase(it->second);
+                shard.map.erase(it);
+                return;
+            }
+        }
+    }
+
+    /// Capacity of single shard.
+    const std::size_t capacity_;
+    std::array<Shard, ShardCount> shards_;
+};
+
 class StyleBuilder final : public ElementVisitor
 {
     typedef std::vector<Tag>::const_iterator TagIterator;
 public:
 
     StyleBuilder(std::vector<Tag> tags, StringTable& stringTable,
-                 const FilterCollection& filters, int levelOfDetail, bool onlyCheck = false) :
+                 const FilterCollection& filters, int levelOfDetail,
+                 StyleCache* cache, bool onlyCheck = false) :
             style(tags, stringTable),
+            stringTable_(stringTable),
             filters_(filters),
             levelOfDetail_(levelOfDetail),
+            cache_(cache),
             onlyCheck_(onlyCheck),
-            canBuild_(false),
-            stringTable_(stringTable)
+            canBuild_(false)
     {
     }
 
-    void visitNode(const Node& node) override { checkOrBuild(node, filters_.nodes); }
+    void visitNode(const Node& node) override { checkOrBuild(node, filters_.nodes, ElementType::Node); }
 
-    void visitWay(const Way& way) override { checkOrBuild(way, filters_.ways); }
+    void visitWay(const Way& way) override { checkOrBuild(way, filters_.ways, ElementType::Way); }
 
-    void visitArea(const Area& area) override { checkOrBuild(area, filters_.areas); }
+    void visitArea(const Area& area) override { checkOrBuild(area, filters_.areas, ElementType::Area); }
 
-    void visitRelation(const Relation& relation) override { checkOrBuild(relation, filters_.relations); }
+    void visitRelation(const Relation& relation) override { checkOrBuild(relation, filters_.relations, ElementType::Relation); }
 
     bool canBuild() const { return canBuild_; }
 
@@ -81,10 +374,32 @@ public:
 
 private:
 
-    void checkOrBuild(const Element& element, const ConditionFilterMap& filters)
+    void checkOrBuild(const Element& element, const ConditionFilterMap& filters, ElementType type)
     {
-        if (!buildFromIdentifier(element))
+        if (buildFromIdentifier(element))
+            return;
+
+        if (cache_ == nullptr) {
             buildFromCondition(element.tags, filters);
+            return;
+        }
+
+        auto resolved = cache_->get(type, levelOfDetail_, element.tags);
+        if (resolved == nullptr) {
+            // NOTE full style is resolved even in check mode as it is likely requested next.
+            onlyCheck_ = false;
+            buildFromCondition(element.tags, filters);
+            auto declarations = style.declarations();
+            resolved = std::make_shared<const ResolvedStyle>(ResolvedStyle { canBuild_, std::move(declarations) });
+            cache_->put(type, levelOfDetail_, element.tags, resolved);
+            return;
+        }
+
+        canBuild_ = resolved->canBuild;
+        if (!onlyCheck_) {
+            for (const auto* declaration : resolved->declarations)
+                style.put(*declaration);
+        }
     }
 
     /// Checks tag's value assuming that the key is already checked.
@@ -98,24 +413,14 @@ private:
             case OpType::NotEquals:
                 return tag.value != condition.value;
             case OpType::Less:
-                return compareDoubles(tag.value, condition.value, std::less<double>());
+                return stringTable_.getNumber(tag.value) < condition.number;
             case OpType::Greater:
-                return compareDoubles(tag.value, condition.value, std::greater<double>());
+                return stringTable_.getNumber(tag.value) > condition.number;
             default:
                 return false;
         }
     }
 
-    /// Compares two raw string values using double conversion.
-    template<typename Func>
-    bool compareDoubles(std::uint32_t left, std::uint32_t right, Func binaryOp)
-    {
-        double leftValue = utymap::utils::parseDouble(stringTable_.getString(left));
-        double rightValue = utymap::utils::parseDouble(stringTable_.getString(right));
-
-        return binaryOp(leftValue, rightValue);
-    }
-
     /// Tries to find tag which satisfy condition using binary search.
     bool matchTags(TagIterator begin, TagIterator end, const ConditionType& condition)
     {
@@ -136,7 +441,10 @@ private:
     {
         ConditionFilterMap::const_iterator iter = filters.find(levelOfDetail_);
         if (iter != filters.end()) {
-            for (const ConditionFilter& filter : iter->second) {
+            std::vector<std::uint32_t> candidates;
+            iter->second.getCandidates(tags, candidates);
+            for (std::uint32_t index : candidates) {
+                const ConditionFilter& filter = iter->second.filters[index];
                 bool isMatched = true;
                 for (auto it = filter.conditions.cbegin(); it != filter.conditions.cend() && isMatched; ++it) {
                     isMatched &= matchTags(tags.cbegin(), tags.cend(), *it);
@@ -172,11 +480,12 @@ private:
         return false;
     }
 
+    const StringTable& stringTable_;
     const FilterCollection &filters_;
     int levelOfDetail_;
+    StyleCache* cache_;
     bool onlyCheck_;
     bool canBuild_;
-    StringTable& stringTable_;
 };
 
 }
@@ -188,10 +497,12 @@ public:
 
     FilterCollection filters;
     StringTable& stringTable;
+    std::unique_ptr<StyleCache> cache;
 
-    StyleProviderImpl(const StyleSheet& stylesheet, StringTable& stringTable) :
+    StyleProviderImpl(const StyleSheet& stylesheet, StringTable& stringTable, std::size_t cacheSize) :
         filters(),
         stringTable(stringTable),
+        cache(cacheSize > 0 ? utymap::utils::make_unique<StyleCache>(cacheSize) : nullptr),
         gradients(),
         textures()
     {
@@ -235,16 +546,10 @@ public:
 
     const ColorGradient& getGradient(const std::string& key)
     {
-        auto gradientPair = gradients.find(key);
-        if (gradientPair == gradients.end()) {
-            auto gradient = utymap::utils::GradientUtils::parseGradient(key);
-            if (gradient->empty())
-                throw MapCssException("Invalid gradient: " + key);
-            std::lock_guard<std::mutex> lock(lock_);
-            gradients.emplace(key, std::move(gradient));
-            gradientPair = gradients.find(key);
-        }
-        return *gradientPair->second;
+        const ColorGradient* gradient = gradients.get(key);
+        if (gradient == nullptr)
+            throw MapCssException("Invalid gradient: " + key);
+        return *gradient;
     }
 
     const TextureGroup& getTexture(std::uint16_t index, const std::string& key) const
@@ -307,6 +612,7 @@ private:
 
             c.key = stringTable.getId(condition.key);
             c.value = stringTable.getId(condition.value);
+            c.number = stringTable.getNumber(c.value);
             filter.conditions.push_back(c);
         }
     }
@@ -315,9 +621,8 @@ private:
     void addDeclarations(const std::vector<Declaration>& declarations, const T& filter)
     {
         for (const auto& declaration : declarations) {
-            if (utymap::utils::GradientUtils::isGradient(declaration.value))
-                addGradient(declaration.value);
-            filter(std::make_shared<const StyleDeclaration>(stringTable.getId(declaration.key), declaration.value));
+            filter(std::make_shared<const StyleDeclaration>(stringTable.getId(declaration.key),
+                declaration.value, stringTable, addGradients(declaration.value)));
         }
     }
 
@@ -326,28 +631,33 @@ private:
         std::sort(filter.conditions.begin(), filter.conditions.end(),
                   [](const ConditionType& c1, const ConditionType& c2) { return c1.key > c2.key; });
         for (int i = selector.zoom.start; i <= selector.zoom.end; ++i) {
-            (*filtersPtr)[i].push_back(filter);
+            (*filtersPtr)[i].add(filter);
         }
     }
 
-    void addGradient(const std::string& key)
+    /// Parses gradients used by declaration value. Returns gradient if value itself is gradient.
+    /// NOTE comma separated lists of colors are used by lsystems.
+    const ColorGradient* addGradients(const std::string& value)
     {
-        if (gradients.find(key) == gradients.end()) {
-            auto gradient = utymap::utils::GradientUtils::parseGradient(key);
-            if (!gradient->empty())
-                gradients.emplace(key, std::move(gradient));
+        if (utymap::utils::GradientUtils::isGradient(value))
+            return gradients.add(value);
+
+        if (value.find(',') != std::string::npos) {
+            for (const auto& part : utymap::utils::splitBy(',', value)) {
+                if (utymap::utils::GradientUtils::isGradient(part))
+                    gradients.add(part);
+            }
         }
+        return nullptr;
     }
 
-    std::mutex lock_;
-
-    std::unordered_map<std::string, std::unique_ptr<const ColorGradient>> gradients;
+    GradientCache gradients;
     std::unordered_map<std::uint16_t, std::unique_ptr<const TextureAtlas>> textures;
     std::unordered_map<std::string, std::unique_ptr<const utymap::lsys::LSystem>> lsystems;
 };
 
-StyleProvider::StyleProvider(const StyleSheet& stylesheet, StringTable& stringTable) :
-    pimpl_(utymap::utils::make_unique<StyleProviderImpl>(stylesheet, stringTable))
+StyleProvider::StyleProvider(const StyleSheet& stylesheet, StringTable& stringTable, std::size_t cacheSize) :
+    pimpl_(utymap::utils::make_unique<StyleProviderImpl>(stylesheet, stringTable, cacheSize))
 {
 }
 
@@ -361,14 +671,16 @@ StyleProvider::StyleProvider(StyleProvider&& other) : pimpl_(std::move(other.pim
 
 bool StyleProvider::hasStyle(const utymap::entities::Element& element, int levelOfDetails) const
 {
-    StyleBuilder builder(element.tags, pimpl_->stringTable, pimpl_->filters, levelOfDetails, true);
+    StyleBuilder builder(element.tags, pimpl_->stringTable, pimpl_->filters, levelOfDetails,
+                         pimpl_->cache.get(), true);
     element.accept(builder);
     return builder.canBuild();
 }
 
 Style StyleProvider::forElement(const Element& element, int levelOfDetails) const
 {
-    StyleBuilder builder(element.tags, pimpl_->stringTable, pimpl_->filters, levelOfDetails);
+    StyleBuilder builder(element.tags, pimpl_->stringTable, pimpl_->filters, levelOfDetails,
+                         pimpl_->cache.get());
     element.accept(builder);
     return std::move(builder.style);
 }
@@ -376,12 +688,24 @@ Style StyleProvider::forElement(const Element& element, int levelOfDetails) cons
 Style StyleProvider::forCanvas(int levelOfDetails) const
 {
     Style style({}, pimpl_->stringTable);
-    for (const auto &filter : pimpl_->filters.canvases[levelOfDetails]) {
+    // NOTE operator[] cannot be used here as it modifies map which is shared between threads.
+    auto filters = pimpl_->filters.canvases.find(levelOfDetails);
+    if (filters == pimpl_->filters.canvases.end())
+        return style;
+
+    for (const auto &filter : filters->second.filters) {
         for (const auto &declaration : filter.declarations) {
             style.put(*declaration);
         }
     }
-    return std::move(style);
+    return style;
+}
+
+StyleProvider::CacheStatistics StyleProvider::getCacheStatistics() const
+{
+    return pimpl_->cache != nullptr
+        ? pimpl_->cache->getStatistics()
+        : CacheStatistics { 0, 0, 0 };
 }
 
 const ColorGradient& StyleProvider::getGradient(const std::string& key) const
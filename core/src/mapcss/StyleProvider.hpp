@@ -8,6 +8,7 @@
 #include "mapcss/Style.hpp"
 #include "lsys/LSystem.hpp"
 
+#include <cstdint>
 #include <string>
 #include <memory>
 
@@ -17,9 +18,20 @@ namespace utymap { namespace mapcss {
 class StyleProvider final
 {
 public:
-
+    /// Represents state of cache of resolved styles.
+    struct CacheStatistics
+    {
+        std::uint64_t hits;
+        std::uint64_t misses;
+        /// Amount of cached tag sets.
+        std::size_t entries;
+    };
+
+    /// Creates style provider. Styles resolved for up to cache size distinct
+    /// tag sets are cached as many elements share the same tags. Zero disables cache.
     StyleProvider(const StyleSheet&, 
-                  utymap::index::StringTable&);
+                  utymap::index::StringTable&,
+                  std::size_t cacheSize = 4096);
 
     ~StyleProvider();
     StyleProvider(StyleProvider&&);
@@ -37,6 +49,9 @@ public:
     /// Returns style for canvas at given level of details.
     Style forCanvas(int levelOfDetails) const;
 
+    /// Returns statistics of resolved styles cache.
+    CacheStatistics getCacheStatistics() const;
+
     /// Returns color gradient for given key.
     const ColorGradient& getGradient(const std::string& key) const;
 
@@ -57,6 +57,12 @@ struct TextureGroup final
         return regions_[seed % regions_.size()];
     }
 
+    /// Returns all regions of the group.
+    const std::vector<TextureRegion>& regions() const
+    {
+        return regions_;
+    }
+
 private:
     std::vector<TextureRegion> regions_;
 };
@@ -84,6 +90,12 @@ struct TextureAtlas final
         return index_;
     }
 
+    /// Returns all texture groups.
+    const Groups& groups() const
+    {
+        return textureGroups_;
+    }
+
     /// Returns a reference to texture group.
     /// Note: returns raw reference from map.
     const TextureGroup& get(const std::string& key) const
@@ -145,6 +157,8 @@ struct StyleSheet final
     std::vector<Rule> rules;
     std::vector<TextureAtlas> textures;
     std::unordered_map<std::string, utymap::lsys::LSystem> lsystems;
+    /// Paths of imported files (mapcss, atlases, lsystems) which stylesheet depends on.
+    std::vector<std::string> sources;
 };
 
 }}
@@ -0,0 +1,461 @@
+#include "Exceptions.hpp"
+#include "hashing/MurmurHash3.h"
+#include "mapcss/MapCssParser.hpp"
+#include "mapcss/StyleSheetCache.hpp"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <typeindex>
+
+using namespace utymap::mapcss;
+using utymap::lsys::LSystem;
+using utymap::lsys::WordRule;
+
+namespace {
+    /// Identifies cache file.
+    const std::uint32_t Magic = 0x53534d55;
+    /// Should be incremented on every change of binary format.
+    const std::uint32_t Version = 1;
+    /// Code of word rule, other rule codes are indices in RulePrototypes.
+    const std::uint8_t WordRuleCode = 0xFF;
+
+    /// Prototypes of lsystem rules without state.
+    /// NOTE order defines binary format: append only.
+    const std::vector<LSystem::RuleType> RulePrototypes = {
+        std::make_shared<utymap::lsys::MoveForwardRule>(),
+        std::make_shared<utymap::lsys::JumpForwardRule>(),
+        std::make_shared<utymap::lsys::TurnLeftRule>(),
+        std::make_shared<utymap::lsys::TurnRightRule>(),
+        std::make_shared<utymap::lsys::TurnAroundRule>(),
+        std::make_shared<utymap::lsys::PitchUpRule>(),
+        std::make_shared<utymap::lsys::PitchDownRule>(),
+        std::make_shared<utymap::lsys::RollLeftRule>(),
+        std::make_shared<utymap::lsys::RollRightRule>(),
+        std::make_shared<utymap::lsys::IncrementRule>(),
+        std::make_shared<utymap::lsys::DecrementRule>(),
+        std::make_shared<utymap::lsys::SwitchStyleRule>(),
+        std::make_shared<utymap::lsys::ScaleUpRule>(),
+        std::make_shared<utymap::lsys::ScaleDownRule>(),
+        std::make_shared<utymap::lsys::SaveRule>(),
+        std::make_shared<utymap::lsys::RestoreRule>()
+    };
+
+    /// Represents hash of file content.
+    struct SourceHash final
+    {
+        std::uint64_t low;
+        std::uint64_t high;
+
+        bool operator==(const SourceHash& other) const { return low == other.low && high == other.high; }
+    };
+
+    /// Computes hash of file content. Throws if file cannot be read.
+    SourceHash getSourceHash(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        if (!file.good())
+            throw utymap::MapCssException(std::string("Cannot read:") + path);
+
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        std::uint64_t hash[2];
+        MurmurHash3_x64_128(content.data(), static_cast<int>(content.size()), 0, hash);
+        return SourceHash{ hash[0], hash[1] };
+    }
+
+    /// Writes stylesheet into binary stream.
+    class Writer final
+    {
+    public:
+        explicit Writer(std::ostream& stream) : stream_(stream)
+        {
+        }
+
+        void write(const std::vector<std::pair<std::string, SourceHash>>& sources, const StyleSheet& stylesheet)
+        {
+            write(Magic);
+            write(Version);
+
+            writeSize(sources.size());
+            for (const auto& source : sources) {
+                write(source.first);
+                write(source.second.low);
+                write(source.second.high);
+            }
+
+            writeSize(stylesheet.rules.size());
+            for (const auto& rule : stylesheet.rules)
+                write(rule);
+
+            writeSize(stylesheet.textures.size());
+            for (const auto& atlas : stylesheet.textures)
+                write(atlas);
+
+            writeSize(stylesheet.lsystems.size());
+            for (const auto& pair : stylesheet.lsystems) {
+                write(pair.first);
+                write(pair.second);
+            }
+        }
+
+    private:
+        template <typename T>
+        void write(const T& value)
+        {
+            stream_.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void writeSize(std::size_t size)
+        {
+            write(static_cast<std::uint32_t>(size));
+        }
+
+        void write(const std::string& str)
+        {
+            writeSize(str.size());
+            stream_.write(str.data(), str.size());
+        }
+
+        void write(const Rule& rule)
+        {
+            writeSize(rule.selectors.size());
+            for (const auto& selector : rule.selectors) {
+                writeSize(selector.names.size());
+                for (const auto& name : selector.names)
+                    write(name);
+
+                write(selector.zoom.start);
+                write(selector.zoom.end);
+
+                writeSize(selector.conditions.size());
+                for (const auto& condition : selector.conditions) {
+                    write(condition.key);
+                    write(condition.operation);
+                    write(condition.value);
+                }
+            }
+
+            writeSize(rule.declarations.size());
+            for (const auto& declaration : rule.declarations) {
+                write(declaration.key);
+                write(declaration.value);
+            }
+        }
+
+        void write(const TextureAtlas& atlas)
+        {
+            write(atlas.index());
+            writeSize(atlas.groups().size());
+            for (const auto& pair : atlas.groups()) {
+                write(pair.first);
+                writeSize(pair.second.regions().size());
+                for (const auto& region : pair.second.regions())
+                    write(region);
+            }
+        }
+
+        void write(const LSystem& lsystem)
+        {
+            write(static_cast<std::int32_t>(lsystem.generations));
+            write(lsystem.angle);
+            write(lsystem.scale);
+            write(lsystem.axiom);
+
+            writeSize(lsystem.productions.size());
+            for (const auto& production : lsystem.productions) {
+                write(production.first);
+                writeSize(production.second.size());
+                for (const auto& pair : production.second) {
+                    write(pair.first);
+                    write(pair.second);
+                }
+            }
+        }
+
+        void write(const LSystem::Rules& rules)
+        {
+            writeSize(rules.size());
+            for (const auto& rule : rules)
+                write(rule);
+        }
+
+        void write(const LSystem::RuleType& rule)
+        {
+            auto type = std::type_index(typeid(*rule));
+            if (type == std::type_index(typeid(WordRule))) {
+                write(WordRuleCode);
+                write(static_cast<const WordRule&>(*rule).word);
+                return;
+            }
+
+            for (std::size_t i = 0; i < RulePrototypes.size(); ++i) {
+                if (type == std::type_index(typeid(*RulePrototypes[i]))) {
+                    write(static_cast<std::uint8_t>(i));
+                    return;
+                }
+            }
+            throw utymap::MapCssException("Cannot serialize unknown lsystem rule.");
+        }
+
+        std::ostream& stream_;
+    };
+
+    /// Reads stylesheet from memory block. Throws if data is truncated.
+    class Reader final
+    {
+    public:
+        Reader(const char* data, std::size_t size) : current_(data), end_(data + size)
+        {
+        }
+
+        /// Reads header and source list. Returns false if format version is different.
+        bool readHeader(std::vector<std::pair<std::string, SourceHash>>& sources)
+        {
+            if (read<std::uint32_t>() != Magic || read<std::uint32_t>() != Version)
+                return false;
+
+            sources.resize(readSize());
+            for (auto& source : sources) {
+                source.first = readString();
+                source.second.low = read<std::uint64_t>();
+                source.second.high = read<std::uint64_t>();
+            }
+            return true;
+        }
+
+        void readBody(StyleSheet& stylesheet)
+        {
+            stylesheet.rules.resize(readSize());
+            for (auto& rule : stylesheet.rules)
+                readRule(rule);
+
+            std::uint32_t atlasCount = readSize();
+            stylesheet.textures.reserve(atlasCount);
+            for (std::uint32_t i = 0; i < atlasCount; ++i)
+                stylesheet.textures.push_back(readAtlas());
+
+            std::uint32_t lsystemCount = readSize();
+            for (std::uint32_t i = 0; i < lsystemCount; ++i) {
+                auto name = readString();
+                stylesheet.lsystems.emplace(name, readLSystem());
+            }
+        }
+
+    private:
+        template <typename T>
+        T read()
+        {
+            T value;
+            readBytes(reinterpret_cast<char*>(&value), sizeof(T));
+            return value;
+        }
+
+        void readBytes(char* destination, std::size_t size)
+        {
+            if (static_cast<std::size_t>(end_ - current_) < size)
+                throw utymap::MapCssException("Stylesheet cache is truncated.");
+            std::memcpy(destination, current_, size);
+            current_ += size;
+        }
+
+        std::uint32_t readSize()
+        {
+            return read<std::uint32_t>();
+        }
+
+        std::string readString()
+        {
+            std::uint32_t size = readSize();
+            if (static_cast<std::size_t>(end_ - current_) < size)
+                throw utymap::MapCssException("Stylesheet cache is truncated.");
+            std::string str(current_, size);
+            current_ += size;
+            return str;
+        }
+
+        void readRule(Rule& rule)
+        {
+            rule.selectors.resize(readSize());
+            for (auto& selector : rule.selectors) {
+                selector.names.resize(readSize());
+                for (auto& name : selector.names)
+                    name = readString();
+
+                selector.zoom.start = read<std::uint8_t>();
+                selector.zoom.end = read<std::uint8_t>();
+
+                selector.conditions.resize(readSize());
+                for (auto& condition : selector.conditions) {
+                    condition.key = readString();
+                    condition.operation = readString();
+                    condition.value = readString();
+                }
+            }
+
+            rule.declarations.resize(readSize());
+            for (auto& declaration : rule.declarations) {
+                declaration.key = readString();
+                declaration.value = readString();
+            }
+        }
+
+        TextureAtlas readAtlas()
+        {
+            auto index = read<std::uint16_t>();
+            TextureAtlas::Groups groups;
+            std::uint32_t groupCount = readSize();
+            for (std::uint32_t i = 0; i < groupCount; ++i) {
+                auto& group = groups[readString()];
+                std::uint32_t regionCount = readSize();
+                for (std::uint32_t j = 0; j < regionCount; ++j) {
+                    auto region = read<TextureRegion>();
+                    group.add(region.atlasWidth, region.atlasHeight, utymap::math::Rectangle(
+                        region.x, region.y, region.x + region.width, region.y + region.height));
+                }
+            }
+            return TextureAtlas(index, groups);
+        }
+
+        LSystem readLSystem()
+        {
+            LSystem lsystem;
+            lsystem.generations = read<std::int32_t>();
+            lsystem.angle = read<double>();
+            lsystem.scale = read<double>();
+            lsystem.axiom = readRules();
+
+            std::uint32_t productionCount = readSize();
+            for (std::uint32_t i = 0; i < productionCount; ++i) {
+                auto& productions = lsystem.productions[readLSystemRule()];
+                productions.resize(readSize());
+                for (auto& pair : productions) {
+                    pair.first = read<double>();
+                    pair.second = readRules();
+                }
+            }
+            return lsystem;
+        }
+
+        LSystem::Rules readRules()
+        {
+            LSystem::Rules rules(readSize());
+            for (auto& rule : rules)
+                rule = readLSystemRule();
+            return rules;
+        }
+
+        LSystem::RuleType readLSystemRule()
+        {
+            auto code = read<std::uint8_t>();
+            if (code == WordRuleCode)
+                return std::make_shared<WordRule>(readString());
+
+            if (code >= RulePrototypes.size())
+                throw utymap::MapCssException("Unknown lsystem rule in stylesheet cache.");
+
+            return RulePrototypes[code];
+        }
+
+        const char* current_;
+        const char* end_;
+    };
+
+    /// Gets directory of given file path.
+    std::string getDirectory(const std::string& path)
+    {
+        // NOTE not safe, but don't want to use boost filesystem only for this task.
+        return path.substr(0, path.find_last_of("\\/") + 1);
+    }
+
+    /// Tries to load up to date stylesheet from cache file.
+    bool tryLoad(const std::string& cachePath, const std::string& stylePath, StyleSheet& stylesheet)
+    {
+        using namespace boost::interprocess;
+        try {
+            file_mapping file(cachePath.c_str(), read_only);
+            mapped_region region(file, read_only);
+            Reader reader(static_cast<const char*>(region.get_address()), region.get_size());
+
+            std::vector<std::pair<std::string, SourceHash>> sources;
+            if (!reader.readHeader(sources) || sources.empty() || sources.front().first != stylePath)
+                return false;
+
+            for (const auto& source : sources) {
+                if (!(getSourceHash(source.first) == source.second))
+                    return false;
+            }
+
+            reader.readBody(stylesheet);
+            for (std::size_t i = 1; i < sources.size(); ++i)
+                stylesheet.sources.push_back(sources[i].first);
+
+            return true;
+        }
+        catch (const std::exception&) {
+            // NOTE missing, corrupted or outdated cache file is not an error: stylesheet is parsed again.
+            stylesheet = StyleSheet();
+            return false;
+        }
+    }
+
+    /// Stores stylesheet in cache file. Failures are ignored as cache is optional.
+    void store(const std::string& cachePath, const std::string& stylePath, const StyleSheet& stylesheet)
+    {
+        std::vector<std::pair<std::string, SourceHash>> sources;
+        sources.push_back(std::make_pair(stylePath, getSourceHash(stylePath)));
+        for (const auto& source : stylesheet.sources)
+            sources.push_back(std::make_pair(source, getSourceHash(source)));
+
+        // NOTE write to temporary file first, so readers never see partially written cache.
+        std::string tempPath = cachePath + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!file.good())
+                return;
+            Writer(file).write(sources, stylesheet);
+            if (!file.good())
+                return;
+        }
+
+        std::remove(cachePath.c_str());
+        std::rename(tempPath.c_str(), cachePath.c_str());
+    }
+}
+
+StyleSheetCache::StyleSheetCache(const std::string& directory) : directory_(directory)
+{
+}
+
+StyleSheet StyleSheetCache::get(const std::string& stylePath) const
+{
+    std::string cachePath = getCachePath(stylePath);
+
+    StyleSheet stylesheet;
+    if (tryLoad(cachePath, stylePath, stylesheet))
+        return stylesheet;
+
+    std::ifstream styleFile(stylePath);
+    if (!styleFile.good())
+        throw std::invalid_argument(std::string("Cannot read mapcss file:") + stylePath);
+
+    stylesheet = MapCssParser(getDirectory(stylePath)).parse(styleFile);
+    store(cachePath, stylePath, stylesheet);
+
+    return stylesheet;
+}
+
+std::string StyleSheetCache::getCachePath(const std::string& stylePath) const
+{
+    std::uint32_t hash;
+    MurmurHash3_x86_32(stylePath.c_str(), static_cast<int>(stylePath.size()), 0, &hash);
+
+    std::stringstream ss;
+    ss << directory_ << "style_" << std::hex << std::setw(8) << std::setfill('0') << hash << ".bin";
+    return ss.str();
+}
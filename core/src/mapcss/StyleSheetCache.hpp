@@ -0,0 +1,31 @@
+#ifndef MAPCSS_STYLESHEETCACHE_HPP_DEFINED
+#define MAPCSS_STYLESHEETCACHE_HPP_DEFINED
+
+#include "mapcss/StyleSheet.hpp"
+
+#include <string>
+
+namespace utymap { namespace mapcss {
+
+/// Keeps parsed stylesheets in versioned binary files to avoid mapcss parsing on every start.
+/// Cached stylesheet is used only while content of mapcss file and all files it imports
+/// (mapcss, texture atlases, lsystems) matches hashes stored in cache file.
+class StyleSheetCache final
+{
+public:
+    /// Directory parameter specifies where cache files are stored.
+    explicit StyleSheetCache(const std::string& directory);
+
+    /// Gets stylesheet from cache if it is up to date. Otherwise, parses
+    /// mapcss file and stores result in cache.
+    StyleSheet get(const std::string& stylePath) const;
+
+    /// Gets path to cache file of given stylesheet.
+    std::string getCachePath(const std::string& stylePath) const;
+
+private:
+    std::string directory_;
+};
+
+}}
+#endif // MAPCSS_STYLESHEETCACHE_HPP_DEFINED
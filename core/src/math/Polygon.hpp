@@ -40,6 +40,17 @@ public:
         addContour(hole, true);
     }
 
+    /// Removes all contours keeping allocated memory, so polygon can be reused.
+    void clear()
+    {
+        points.clear();
+        holes.clear();
+        segments.clear();
+        outers.clear();
+        inners.clear();
+        rectangle = Rectangle();
+    }
+
 private:
 
     void addContour(const std::vector<Vector2>& contour, bool isHole)
@@ -0,0 +1,32 @@
+#ifndef UTILS_CANCELLATIONTOKEN_HPP_DEFINED
+#define UTILS_CANCELLATIONTOKEN_HPP_DEFINED
+
+#include <atomic>
+
+namespace utymap { namespace utils {
+
+/// Allows to request cooperative cancellation of long running operation.
+/// NOTE operation is responsible for checking token at safe points.
+class CancellationToken final
+{
+public:
+    CancellationToken() : isCancelled_(false)
+    {
+    }
+
+    CancellationToken(const CancellationToken&) = delete;
+    CancellationToken& operator=(const CancellationToken&) = delete;
+
+    /// Requests cancellation. Can be called from any thread.
+    void cancel() { isCancelled_.store(true, std::memory_order_relaxed); }
+
+    /// Checks whether cancellation is requested.
+    bool isCancelled() const { return isCancelled_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> isCancelled_;
+};
+
+}}
+
+#endif // UTILS_CANCELLATIONTOKEN_HPP_DEFINED
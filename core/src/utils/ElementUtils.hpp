@@ -1,13 +1,21 @@
 #ifndef UTILS_ELEMENTUTILS_HPP_DEFINED
 #define UTILS_ELEMENTUTILS_HPP_DEFINED
 
+#include "BoundingBox.hpp"
 #include "entities/Element.hpp"
+#include "entities/ElementVisitor.hpp"
+#include "entities/Node.hpp"
+#include "entities/Way.hpp"
+#include "entities/Area.hpp"
+#include "entities/Relation.hpp"
 #include "formats/FormatTypes.hpp"
 #include "formats/osm/OsmDataContext.hpp"
 #include "index/StringTable.hpp"
 #include "utils/CoreUtils.hpp"
 
 #include <algorithm>
+#include <memory>
+#include <vector>
 
 namespace utymap { namespace utils {
 
@@ -124,6 +132,68 @@ static void visitRelationMembers(const utymap::formats::OsmDataContext& context,
     }
 }
 
+/// Copies visited elements into given collection.
+/// NOTE visited elements can be reused by their producer, so copies are stored.
+class ElementCollector final : public utymap::entities::ElementVisitor
+{
+public:
+    explicit ElementCollector(std::vector<std::shared_ptr<utymap::entities::Element>>& elements) :
+        elements_(elements)
+    {
+    }
+
+    void visitNode(const utymap::entities::Node& node) override
+    {
+        elements_.push_back(std::make_shared<utymap::entities::Node>(node));
+    }
+
+    void visitWay(const utymap::entities::Way& way) override
+    {
+        elements_.push_back(std::make_shared<utymap::entities::Way>(way));
+    }
+
+    void visitArea(const utymap::entities::Area& area) override
+    {
+        elements_.push_back(std::make_shared<utymap::entities::Area>(area));
+    }
+
+    void visitRelation(const utymap::entities::Relation& relation) override
+    {
+        elements_.push_back(std::make_shared<utymap::entities::Relation>(relation));
+    }
+
+private:
+    std::vector<std::shared_ptr<utymap::entities::Element>>& elements_;
+};
+
+/// Creates bounding box of visited elements.
+class BoundingBoxVisitor final : public utymap::entities::ElementVisitor
+{
+public:
+    utymap::BoundingBox boundingBox;
+
+    void visitNode(const utymap::entities::Node& node) override
+    {
+        boundingBox.expand(node.coordinate);
+    }
+
+    void visitWay(const utymap::entities::Way& way) override
+    {
+        boundingBox.expand(way.coordinates.cbegin(), way.coordinates.cend());
+    }
+
+    void visitArea(const utymap::entities::Area& area) override
+    {
+        boundingBox.expand(area.coordinates.cbegin(), area.coordinates.cend());
+    }
+
+    void visitRelation(const utymap::entities::Relation& relation) override
+    {
+        for (const auto& element : relation.elements)
+            element->accept(*this);
+    }
+};
+
 }}
 
 #endif // UTILS_ELEMENTUTILS_HPP_DEFINED
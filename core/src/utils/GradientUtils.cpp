@@ -1,6 +1,7 @@
 #include "utils/CoreUtils.hpp"
 #include "utils/GradientUtils.hpp"
 
+#include <algorithm>
 #include <sstream>
 
 using namespace utymap::mapcss;
@@ -10,6 +11,9 @@ namespace
 {
     const std::string GradientPrefix = "gradient(";
 
+    /// Amount of points processed at once by batched color evaluation.
+    const std::size_t ColorBatchSize = 256;
+
     const std::unordered_map<std::string, Color> colorMap =
     {
         { "activeborder", Color(180, 180, 180, 255) },
@@ -303,5 +307,23 @@ const ColorGradient& GradientUtils::evaluateGradient(const StyleProvider& styleP
                                                      const std::string &key)
 {
     // TODO evaluate gradient using tags
-    return styleProvider.getGradient(style.getString(key));
+    const ColorGradient* gradient = style.getGradient(key);
+    return gradient != nullptr
+        ? *gradient
+        : styleProvider.getGradient(style.getString(key));
+}
+
+void GradientUtils::getColors(const ColorGradient& gradient,
+                              const double* points, std::size_t count, double noise, int* colors)
+{
+    const auto& table = gradient.lookupTable();
+    double times[ColorBatchSize];
+
+    for (std::size_t start = 0; start < count; start += ColorBatchSize) {
+        std::size_t size = std::min(ColorBatchSize, count - start);
+        NoiseUtils::perlin2D(points + start * 2, size, noise, times);
+
+        for (std::size_t i = 0; i < size; ++i)
+            colors[start + i] = static_cast<int>(table[ColorGradient::getLookupIndex((times[i] + 1) / 2)]);
+    }
 }
@@ -41,6 +41,11 @@ public:
         return gradient.evaluate(colorTime);
     }
 
+    /// Gets colors for count points stored as interleaved x, y pairs using coherent noise
+    /// function and lookup table of gradient. Colors are written in rgba format.
+    static void getColors(const utymap::mapcss::ColorGradient& gradient,
+                          const double* points, std::size_t count, double noise, int* colors);
+
 private:
     static const std::regex gradientRegEx;
 };
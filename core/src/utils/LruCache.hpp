@@ -0,0 +1,255 @@
+#ifndef UTILS_LRUCACHE_HPP_DEFINED
+#define UTILS_LRUCACHE_HPP_DEFINED
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace utymap { namespace utils {
+
+/// Keeps limited amount of values evicting least recently used one when full.
+/// Lookup of resident value does not lock: readers use immutable snapshot of entries
+/// published through atomic pointer, writer builds new snapshot on miss. Reader pins
+/// snapshot by its own slot of snapshot's reader counter, so concurrent hits do not
+/// write the same cache line except reference count of returned value.
+/// Snapshots are reused once they are neither current nor pinned, so their amount is
+/// bounded by amount of concurrent readers. Recency is tracked by coarse clock which
+/// advances on miss only. Designed for small amount of heavy values, so linear search is used.
+/// NOTE evicted value is released when its snapshot is not pinned on the next miss at latest.
+/// Returned pointer keeps value alive even if it is evicted concurrently.
+template <typename Key, typename Value>
+class LruCache final
+{
+public:
+    typedef std::shared_ptr<const Value> ValuePtr;
+
+    /// Loads value for given key into cache if it is missing.
+    /// Returns false if cache is full, so nothing can be loaded anymore.
+    typedef std::function<bool(const Key&)> Loader;
+
+private:
+    struct Entry
+    {
+        Key key;
+        ValuePtr value;
+        /// Clock time of last access used to find least recently used entry.
+        mutable std::atomic<std::uint64_t> lastUsed;
+
+        Entry(const Key& key, const ValuePtr& value, std::uint64_t lastUsed) :
+            key(key), value(value), lastUsed(lastUsed)
+        {
+        }
+
+        Entry(const Entry& other) :
+            key(other.key), value(other.value), lastUsed(other.lastUsed.load(std::memory_order_relaxed))
+        {
+        }
+
+        Entry& operator=(const Entry& other)
+        {
+            key = other.key;
+            value = other.value;
+            lastUsed.store(other.lastUsed.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return *this;
+        }
+    };
+
+    typedef std::vector<Entry> Entries;
+
+    /// Amount of reader counter slots of snapshot.
+    static const std::size_t ReaderSlots = 8;
+
+    /// Reader counter slot padded to occupy own cache line.
+    struct ReaderCount
+    {
+        std::atomic<std::uint32_t> value;
+        char padding[64 - sizeof(std::atomic<std::uint32_t>)];
+    };
+
+    struct Snapshot
+    {
+        Entries entries;
+        ReaderCount readers[ReaderSlots];
+
+        Snapshot() : entries()
+        {
+            for (auto& count : readers)
+                count.value.store(0, std::memory_order_relaxed);
+        }
+
+        bool isPinned() const
+        {
+            for (const auto& count : readers) {
+                if (count.value.load() != 0)
+                    return true;
+            }
+            return false;
+        }
+    };
+
+public:
+    explicit LruCache(std::size_t capacity) :
+        capacity_(std::max(capacity, static_cast<std::size_t>(1))),
+        clock_(0),
+        current_(nullptr),
+        snapshots_()
+    {
+        snapshots_.push_back(std::unique_ptr<Snapshot>(new Snapshot()));
+        current_.store(snapshots_.back().get());
+    }
+
+    LruCache(const LruCache&) = delete;
+    LruCache& operator=(const LruCache&) = delete;
+
+    /// Gets value for given key creating it by factory on miss.
+    template <typename Factory>
+    ValuePtr get(const Key& key, const Factory& factory)
+    {
+        return get(key, factory, [](const Loader&) { });
+    }
+
+    /// Gets value for given key creating it by factory on miss. On miss, preload
+    /// is called with loader which can be used to load other values at once.
+    /// NOTE factory and preload are called under lock. If any of them throws,
+    /// cache is left unchanged.
+    template <typename Factory, typename Preload>
+    ValuePtr get(const Key& key, const Factory& factory, const Preload& preload)
+    {
+        auto value = find(key);
+        if (value != nullptr)
+            return value;
+
+        std::lock_guard<std::mutex> lock(lock_);
+
+        // another thread might load value while we were waiting for lock.
+        // NOTE current snapshot is changed only under lock, so it is read without pinning.
+        const Entries& entries = current_.load(std::memory_order_relaxed)->entries;
+        value = find(entries, key);
+        if (value != nullptr)
+            return value;
+
+        Entries newEntries(entries);
+        value = load(newEntries, key, factory);
+        preload(Loader([&](const Key& other) {
+            if (newEntries.size() >= capacity_)
+                return false;
+            if (find(newEntries, other) == nullptr)
+                load(newEntries, other, factory);
+            return true;
+        }));
+
+        publish(std::move(newEntries));
+        // NOTE loaded entries should be older than the ones used after this miss.
+        clock_.store(clock_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return value;
+    }
+
+    /// Returns amount of values in cache.
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        return current_.load(std::memory_order_relaxed)->entries.size();
+    }
+
+private:
+    /// Finds value in current snapshot pinning it for the time of search.
+    ValuePtr find(const Key& key) const
+    {
+        std::size_t slot = getReaderSlot();
+        while (true) {
+            Snapshot* snapshot = current_.load();
+            auto& readers = snapshot->readers[slot].value;
+            readers.fetch_add(1);
+            // NOTE snapshot might be replaced and reused before it is pinned.
+            if (current_.load() == snapshot) {
+                auto value = find(snapshot->entries, key);
+                readers.fetch_sub(1, std::memory_order_release);
+                return value;
+            }
+            readers.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    /// Finds value in given entries marking it as recently used.
+    ValuePtr find(const Entries& entries, const Key& key) const
+    {
+        for (const auto& entry : entries) {
+            if (entry.key == key) {
+                // NOTE entry is written only when it is used first time since the last miss.
+                std::uint64_t now = clock_.load(std::memory_order_relaxed);
+                if (entry.lastUsed.load(std::memory_order_relaxed) != now)
+                    entry.lastUsed.store(now, std::memory_order_relaxed);
+                return entry.value;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Loads value into given entries evicting least recently used one if cache is full.
+    template <typename Factory>
+    ValuePtr load(Entries& entries, const Key& key, const Factory& factory)
+    {
+        ValuePtr value = factory(key);
+
+        if (entries.size() >= capacity_) {
+            auto leastUsed = std::min_element(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+                return a.lastUsed.load(std::memory_order_relaxed) < b.lastUsed.load(std::memory_order_relaxed);
+            });
+            entries.erase(leastUsed);
+        }
+
+        entries.emplace_back(key, value, clock_.load(std::memory_order_relaxed));
+        return value;
+    }
+
+    /// Makes given entries current and releases entries of snapshots which are not used anymore.
+    /// Should be called under lock.
+    void publish(Entries&& entries)
+    {
+        Snapshot* current = current_.load(std::memory_order_relaxed);
+        Snapshot* snapshot = nullptr;
+        for (const auto& candidate : snapshots_) {
+            if (candidate.get() != current && !candidate->isPinned()) {
+                snapshot = candidate.get();
+                break;
+            }
+        }
+        if (snapshot == nullptr) {
+            snapshots_.push_back(std::unique_ptr<Snapshot>(new Snapshot()));
+            snapshot = snapshots_.back().get();
+        }
+
+        snapshot->entries = std::move(entries);
+        current_.store(snapshot);
+
+        for (const auto& retired : snapshots_) {
+            if (retired.get() != snapshot && !retired->isPinned())
+                retired->entries.clear();
+        }
+    }
+
+    /// Gets index of reader counter slot used by calling thread.
+    static std::size_t getReaderSlot()
+    {
+        static thread_local std::size_t slot = std::hash<std::thread::id>()(std::this_thread::get_id()) % ReaderSlots;
+        return slot;
+    }
+
+    const std::size_t capacity_;
+    /// Coarse clock which advances after every miss.
+    std::atomic<std::uint64_t> clock_;
+    std::atomic<Snapshot*> current_;
+    /// Current snapshot and snapshots which can be reused.
+    std::vector<std::unique_ptr<Snapshot>> snapshots_;
+    mutable std::mutex lock_;
+};
+
+}}
+
+#endif // UTILS_LRUCACHE_HPP_DEFINED
@@ -4,6 +4,8 @@
 #include "math/Mesh.hpp"
 #include "math/Vector3.hpp"
 
+#include <vector>
+
 namespace utymap { namespace utils {
 
 /// Copies mesh into existing one with offset.
@@ -45,13 +47,21 @@ inline void copyMeshAlong(const utymap::QuadKey& quadKey, const utymap::GeoCoord
     double distanceInMeters = GeoUtils::distance(p1, p2);
     int count = static_cast<int>(distanceInMeters / stepInMeters);
 
+    if (count <= 0) return;
+
+    std::vector<double> latitudes(count), longitudes(count), elevations(count);
     for (int j = 0; j < count; ++j) {
         GeoCoordinate newPosition = GeoUtils::newPoint(p1, p2, static_cast<double>(j) / count);
+        latitudes[j] = newPosition.latitude;
+        longitudes[j] = newPosition.longitude;
+    }
 
-        double elevation = eleProvider.getElevation(quadKey, newPosition);
-        utymap::utils::copyMesh(utymap::math::Vector3(newPosition.longitude - position.longitude,
-                                                      elevation,
-                                                      newPosition.latitude - position.latitude),
+    eleProvider.getElevations(quadKey, latitudes.data(), longitudes.data(), elevations.data(), elevations.size());
+
+    for (int j = 0; j < count; ++j) {
+        utymap::utils::copyMesh(utymap::math::Vector3(longitudes[j] - position.longitude,
+                                                      elevations[j],
+                                                      latitudes[j] - position.latitude),
             source, destination);
     }
 }
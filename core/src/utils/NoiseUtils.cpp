@@ -1,5 +1,6 @@
 #include "utils/NoiseUtils.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 using namespace utymap::math;
@@ -79,7 +80,23 @@ double NoiseUtils::perlin2D(double x, double y, double frequency)
 {
     if (frequency < 1E-5) return 0;
 
-    Vector2 point(x * frequency, y* frequency);
+    return noise2D(x * frequency, y * frequency);
+}
+
+void NoiseUtils::perlin2D(const double* points, std::size_t count, double frequency, double* result)
+{
+    if (frequency < 1E-5) {
+        std::fill(result, result + count, 0.);
+        return;
+    }
+
+    for (std::size_t i = 0; i < count; ++i)
+        result[i] = noise2D(points[i * 2] * frequency, points[i * 2 + 1] * frequency);
+}
+
+double NoiseUtils::noise2D(double x, double y)
+{
+    Vector2 point(x, y);
 
     int ix0 = static_cast<int>(std::floor(point.x));
     int iy0 = static_cast<int>(std::floor(point.y));
@@ -4,6 +4,8 @@
 #include "math/Vector2.hpp"
 #include "math/Vector3.hpp"
 
+#include <cstddef>
+
 namespace utymap { namespace utils {
 
 /// Provides noise generation functions.
@@ -14,10 +16,15 @@ public:
     /// Calculates perlin 2D noise.
     static double perlin2D(double x, double y, double frequency);
 
+    /// Calculates perlin 2D noise for count points stored as interleaved x, y pairs.
+    static void perlin2D(const double* points, std::size_t count, double frequency, double* result);
+
     /// Calculates perlin 3D noise.
     static double perlin3D(double x, double y, double z, double freq);
 
 private:
+    /// Calculates perlin 2D noise for point already scaled by frequency.
+    static double noise2D(double x, double y);
 
     static double dot(const utymap::math::Vector3& g, double x, double y, double z)
     {
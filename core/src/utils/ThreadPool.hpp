@@ -0,0 +1,85 @@
+#ifndef UTILS_THREADPOOL_HPP_DEFINED
+#define UTILS_THREADPOOL_HPP_DEFINED
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace utymap { namespace utils {
+
+/// Executes tasks using fixed amount of worker threads.
+/// NOTE tasks should not wait for other tasks enqueued into the same pool.
+class ThreadPool final
+{
+public:
+    explicit ThreadPool(std::size_t threadCount) : stop_(false)
+    {
+        for (std::size_t i = 0; i < threadCount; ++i)
+            workers_.emplace_back([this]() { run(); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Waits for all enqueued tasks and stops worker threads.
+    ~ThreadPool()
+    {
+        {
+            std::unique_lock<std::mutex> lock(lock_);
+            stop_ = true;
+        }
+        condition_.notify_all();
+        for (auto& worker : workers_)
+            worker.join();
+    }
+
+    /// Returns amount of worker threads.
+    std::size_t size() const { return workers_.size(); }
+
+    /// Enqueues task for execution. Exception thrown by task is rethrown by future.
+    template <typename Task>
+    std::future<void> enqueue(Task&& task)
+    {
+        auto packaged = std::make_shared<std::packaged_task<void()>>(std::forward<Task>(task));
+        std::future<void> result = packaged->get_future();
+        {
+            std::unique_lock<std::mutex> lock(lock_);
+            tasks_.emplace([packaged]() { (*packaged)(); });
+        }
+        condition_.notify_one();
+        return result;
+    }
+
+private:
+    void run()
+    {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(lock_);
+                condition_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+                if (stop_ && tasks_.empty())
+                    return;
+
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex lock_;
+    std::condition_variable condition_;
+    bool stop_;
+};
+
+}}
+
+#endif // UTILS_THREADPOOL_HPP_DEFINED
@@ -3,6 +3,8 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <set>
+
 #include "test_utils/ElementUtils.hpp"
 
 using namespace utymap::entities;
@@ -13,6 +15,8 @@ namespace {
 
     // Use global variable as it is used inside lambda which is passed as function.
     bool isCalled;
+    // Indices of tiles which callbacks are called for during batch load.
+    std::set<int> loadedTiles;
 
     struct ExportLibFixture {
         ExportLibFixture()
@@ -61,6 +65,7 @@ namespace {
             ::cleanup();
             std::remove((std::string(TEST_ASSETS_PATH) + "string.idx").c_str());
             std::remove((std::string(TEST_ASSETS_PATH) + "string.dat").c_str());
+            std::remove(utymap::mapcss::StyleSheetCache(TEST_ASSETS_PATH).getCachePath(TEST_MAPCSS_DEFAULT).c_str());
         }
     };
 }
@@ -82,6 +87,37 @@ BOOST_AUTO_TEST_CASE(GivenTestData_WhenAllQuadKeysAreLoadedAtZoomOne_ThenCallbac
     loadQuadKeys(1, 0, 1, 0, 1);
 }
 
+BOOST_AUTO_TEST_CASE(GivenTestData_WhenAllQuadKeysAreLoadedInBatchAtZoomOne_ThenCallbacksAreCalledForEveryTile)
+{
+    ::addToStoreInRange(InMemoryStoreKey, TEST_MAPCSS_DEFAULT, TEST_SHAPE_NE_110M_LAND, 1, 1, callback);
+    ::addToStoreInRange(InMemoryStoreKey, TEST_MAPCSS_DEFAULT, TEST_SHAPE_NE_110M_LAKES, 1, 1, callback);
+    const std::vector<int> quadKeys = { 0, 0, 1, 1, 0, 1, 0, 1, 1, 1, 1, 1 };
+    loadedTiles.clear();
+
+    ::loadQuadKeys(TEST_MAPCSS_DEFAULT, quadKeys.data(), 4, 0,
+        [](int tileIndex, const char* name,
+           const double* vertices, int vertexCount,
+           const int* triangles, int triCount,
+           const int* colors, int colorCount,
+           const double* uvs, int uvCount,
+           const int* uvMap, int uvMapCount) {
+        loadedTiles.insert(tileIndex);
+        BOOST_CHECK_GT(vertexCount, 0);
+        BOOST_CHECK_GT(triCount, 0);
+    },
+        [](int tileIndex, uint64_t id, const char** tags, int size, const double* vertices,
+           int vertexCount, const char** style, int styleSize) {
+        loadedTiles.insert(tileIndex);
+    },
+        [](int tileIndex, const char* message) {
+        BOOST_FAIL(message);
+    });
+
+    BOOST_CHECK_EQUAL(loadedTiles.size(), 4);
+    BOOST_CHECK_EQUAL(*loadedTiles.begin(), 0);
+    BOOST_CHECK_EQUAL(*loadedTiles.rbegin(), 3);
+}
+
 BOOST_AUTO_TEST_CASE(GivenTestData_WhenQuadKeysAreLoadedAtBirdEyeZoomLevel_ThenCallbacksAreCalled)
 {
     ::addToStoreInQuadKey(InMemoryStoreKey, TEST_MAPCSS_DEFAULT, TEST_JSON_2_FILE, 8800, 5373, 14, callback);
@@ -0,0 +1,137 @@
+#include "QuadKey.hpp"
+#include "builders/BuildQueue.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace utymap;
+using namespace utymap::builders;
+using namespace utymap::utils;
+
+namespace {
+    const int LevelOfDetail = 1;
+
+    struct Builders_BuildQueueFixture
+    {
+        Builders_BuildQueueFixture() : queue(1), gate(), opened(gate.get_future().share())
+        {
+        }
+
+        /// Occupies the only worker till gate is opened, so next tasks stay pending.
+        void block()
+        {
+            auto started = std::make_shared<std::promise<void>>();
+            auto future = started->get_future();
+            auto opened = this->opened;
+            queue.enqueue(QuadKey(LevelOfDetail, 1, 1), 0, [started, opened](const QuadKey&, const CancellationToken&) {
+                started->set_value();
+                opened.wait();
+            });
+            future.wait();
+        }
+
+        /// Creates task which records quadkey which is built.
+        BuildQueue::BuildTask record()
+        {
+            return [this](const QuadKey& quadKey, const CancellationToken&) {
+                std::lock_guard<std::mutex> lock(builtLock);
+                built.push_back(quadKey.tileX);
+            };
+        }
+
+        void open()
+        {
+            gate.set_value();
+            queue.wait();
+        }
+
+        BuildQueue queue;
+        std::promise<void> gate;
+        std::shared_future<void> opened;
+        std::mutex builtLock;
+        std::vector<int> built;
+    };
+}
+
+BOOST_FIXTURE_TEST_SUITE(Builders_BuildQueue, Builders_BuildQueueFixture)
+
+BOOST_AUTO_TEST_CASE(GivenPendingTasks_WhenBuild_ThenTasksAreBuiltInPriorityOrder)
+{
+    block();
+    queue.enqueue(QuadKey(LevelOfDetail, 0, 0), 3, record());
+    queue.enqueue(QuadKey(LevelOfDetail, 1, 0), 1, record());
+    queue.enqueue(QuadKey(LevelOfDetail, 2, 0), 2, record());
+
+    open();
+
+    BOOST_CHECK((built == std::vector<int>{ 1, 2, 0 }));
+}
+
+BOOST_AUTO_TEST_CASE(GivenPendingTask_WhenEnqueueSameQuadKey_ThenNewTaskIsBuiltOnceWithNewPriority)
+{
+    block();
+    queue.enqueue(QuadKey(LevelOfDetail, 0, 0), 1, record());
+    queue.enqueue(QuadKey(LevelOfDetail, 1, 0), 2, [this](const QuadKey&, const CancellationToken&) {
+        std::lock_guard<std::mutex> lock(builtLock);
+        built.push_back(-1);
+    });
+
+    bool isScheduled = queue.enqueue(QuadKey(LevelOfDetail, 1, 0), 0, record());
+    open();
+
+    BOOST_CHECK(isScheduled);
+    BOOST_CHECK((built == std::vector<int>{ 1, 0 }));
+}
+
+BOOST_AUTO_TEST_CASE(GivenRunningTask_WhenEnqueueSameQuadKey_ThenTaskIsNotScheduled)
+{
+    block();
+
+    bool isScheduled = queue.enqueue(QuadKey(LevelOfDetail, 1, 1), 0, record());
+    open();
+
+    BOOST_CHECK(!isScheduled);
+    BOOST_CHECK(built.empty());
+}
+
+BOOST_AUTO_TEST_CASE(GivenPendingTask_WhenCancel_ThenItIsNotBuilt)
+{
+    block();
+    queue.enqueue(QuadKey(LevelOfDetail, 0, 0), 1, record());
+    queue.enqueue(QuadKey(LevelOfDetail, 1, 0), 2, record());
+
+    bool isCancelled = queue.cancel(QuadKey(LevelOfDetail, 0, 0));
+    open();
+
+    BOOST_CHECK(isCancelled);
+    BOOST_CHECK((built == std::vector<int>{ 1 }));
+}
+
+BOOST_AUTO_TEST_CASE(GivenRunningTask_WhenCancel_ThenTokenIsCancelled)
+{
+    std::promise<void> started;
+    auto future = started.get_future();
+    std::atomic<bool> isStopped(false);
+    queue.enqueue(QuadKey(LevelOfDetail, 0, 0), 0, [&](const QuadKey&, const CancellationToken& cancelToken) {
+        started.set_value();
+        while (!cancelToken.isCancelled())
+            std::this_thread::yield();
+        isStopped = true;
+    });
+    future.wait();
+
+    bool isCancelled = queue.cancel(QuadKey(LevelOfDetail, 0, 0));
+    queue.wait();
+
+    BOOST_CHECK(isCancelled);
+    BOOST_CHECK(isStopped);
+    gate.set_value();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
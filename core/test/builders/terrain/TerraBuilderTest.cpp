@@ -30,10 +30,11 @@ namespace {
         DependencyProvider dependencyProvider;
         std::unique_ptr<BuilderContext> context = nullptr;
 
-        std::unique_ptr<TerraBuilder> create(const QuadKey& quadKey, std::function<void(const utymap::math::Mesh&)> meshCallback)
+        std::unique_ptr<TerraBuilder> create(const QuadKey& quadKey, std::function<void(const utymap::math::Mesh&)> meshCallback,
+                                             const std::string& style = stylesheet)
         {
             context = utymap::utils::make_unique<BuilderContext>(quadKey,
-                                                                 *dependencyProvider.getStyleProvider(stylesheet),
+                                                                 *dependencyProvider.getStyleProvider(style),
                                                                  *dependencyProvider.getStringTable(),
                                                                  *dependencyProvider.getElevationProvider(),
                                                                  meshCallback, nullptr);
@@ -63,4 +64,23 @@ BOOST_AUTO_TEST_CASE(GivenArea_WhenComplete_ThenSurfaceMeshIsNotEmpty)
     BOOST_CHECK(isCalled);
 }
 
+BOOST_AUTO_TEST_CASE(GivenAreaAndGridMeshType_WhenComplete_ThenSurfaceMeshIsNotEmpty)
+{
+    bool isCalled = false;
+    auto terraBuilder = create(QuadKey(1, 0, 0), [&](const Mesh& mesh) {
+        if (mesh.name != "terrain_surface") return;
+        BOOST_CHECK_GT(mesh.vertices.size(), 0);
+        BOOST_CHECK_GT(mesh.triangles.size(), 0);
+        isCalled = true;
+    }, "canvas|z1 { mesh-type: grid;" + stylesheet.substr(std::string("canvas|z1 {").size()));
+    ElementUtils::createElement<Area>(*dependencyProvider.getStringTable(), 0,
+            { { "landuse", "commercial" } },
+            { { 0, 0 }, { 20, 0 }, { 20, 20 }, { 0, 20 } })
+        .accept(*terraBuilder);
+
+    terraBuilder->complete();
+
+    BOOST_CHECK(isCalled);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
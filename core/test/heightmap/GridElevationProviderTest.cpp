@@ -2,6 +2,10 @@
 
 #include "config.hpp"
 #include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include <cstdio>
+#include <fstream>
 
 using namespace utymap;
 using namespace utymap::heightmap;
@@ -21,6 +25,11 @@ namespace {
         {
         }
 
+        ~Heightmap_GridElevationProviderFixture()
+        {
+            std::remove(eleProvider.getBinaryFilePath(quadKey).c_str());
+        }
+
         QuadKey quadKey;
         BoundingBox bbox;
         GridElevationProvider eleProvider;
@@ -72,4 +81,86 @@ BOOST_AUTO_TEST_CASE(GivenLocationNearTopRight_WhenGetElevation_ThenReturnExpect
     BOOST_CHECK_CLOSE(ele, 4.5, Precision);
 }
 
+BOOST_AUTO_TEST_CASE(GivenLocations_WhenGetElevations_ThenReturnSameHeightsAsSingleCalls)
+{
+    const double latitudes[] = { bbox.minPoint.latitude, bbox.maxPoint.latitude, bbox.center().latitude,
+                                 bbox.center().latitude + bbox.height() / 4 };
+    const double longitudes[] = { bbox.minPoint.longitude, bbox.maxPoint.longitude, bbox.center().longitude,
+                                  bbox.center().longitude + bbox.width() / 4 };
+    double elevations[4];
+
+    eleProvider.getElevations(quadKey, latitudes, longitudes, elevations, 4);
+
+    for (std::size_t i = 0; i < 4; ++i)
+        BOOST_CHECK_EQUAL(elevations[i], eleProvider.getElevation(quadKey, latitudes[i], longitudes[i]));
+}
+
+BOOST_AUTO_TEST_CASE(GivenTextGrid_WhenGetElevation_ThenBinaryGridIsCreated)
+{
+    eleProvider.getElevation(quadKey, bbox.center());
+
+    BOOST_CHECK(boost::filesystem::exists(eleProvider.getBinaryFilePath(quadKey)));
+}
+
+BOOST_AUTO_TEST_CASE(GivenOnlyBinaryGrids_WhenGetElevationWithCacheSizeLimit_ThenReturnExpectedHeightAndCacheSizeIsBounded)
+{
+    namespace fs = boost::filesystem;
+    fs::path directory = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directories(directory / "16");
+    QuadKey otherQuadKey(16, 35205, 21490);
+    GridElevationProvider otherProvider(directory.string() + "/", 1);
+    for (const auto& key : { quadKey, otherQuadKey }) {
+        BOOST_REQUIRE(GridElevationConverter::convert(TEST_ASSETS_PATH "16/1202102332220103.ele",
+                                                      otherProvider.getBinaryFilePath(key),
+                                                      utymap::utils::GeoUtils::quadKeyToBoundingBox(key)));
+    }
+    BoundingBox otherBbox = utymap::utils::GeoUtils::quadKeyToBoundingBox(otherQuadKey);
+
+    double ele = otherProvider.getElevation(quadKey, bbox.maxPoint);
+    double otherEle = otherProvider.getElevation(otherQuadKey, otherBbox.maxPoint);
+    std::size_t cacheSize = otherProvider.getCacheSize();
+    fs::remove_all(directory);
+
+    BOOST_CHECK_CLOSE(ele, 5, Precision);
+    BOOST_CHECK_CLOSE(otherEle, 5, Precision);
+    BOOST_CHECK_EQUAL(cacheSize, 1);
+}
+
+BOOST_AUTO_TEST_CASE(GivenTextGridRewrittenInSameTickAsConversion_WhenGetElevation_ThenBinaryGridIsRecreated)
+{
+    namespace fs = boost::filesystem;
+    fs::path directory = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directories(directory / "16");
+    std::string textPath = (directory / "16" / "1202102332220103.ele").string();
+    std::ofstream(textPath) << "-3 -2 -1 0 1 2 3 4 5";
+    GridElevationProvider provider(directory.string() + "/");
+    double ele = provider.getElevation(quadKey, bbox.maxPoint);
+
+    std::ofstream(textPath) << "-3 -2 -1 0 1 2 3 4 7";
+    fs::last_write_time(textPath, fs::last_write_time(provider.getBinaryFilePath(quadKey)));
+    double otherEle = GridElevationProvider(directory.string() + "/").getElevation(quadKey, bbox.maxPoint);
+    fs::remove_all(directory);
+
+    BOOST_CHECK_CLOSE(ele, 5, Precision);
+    BOOST_CHECK_CLOSE(otherEle, 7, Precision);
+}
+
+BOOST_AUTO_TEST_CASE(GivenBinaryGridWithAnotherByteOrder_WhenIsValid_ThenReturnsFalse)
+{
+    namespace fs = boost::filesystem;
+    std::string binaryPath = (fs::temp_directory_path() / fs::unique_path()).string();
+    BOOST_REQUIRE(GridElevationConverter::convert(TEST_ASSETS_PATH "16/1202102332220103.ele", binaryPath, bbox));
+    GridElevationConverter::Header header;
+    std::ifstream(binaryPath, std::ios::binary).read(reinterpret_cast<char*>(&header), sizeof(header));
+    std::size_t fileSize = static_cast<std::size_t>(fs::file_size(binaryPath));
+    fs::remove(binaryPath);
+
+    bool isValid = GridElevationConverter::isValid(header, fileSize);
+    header.byteOrder = 0x04030201;
+    bool isSwappedValid = GridElevationConverter::isValid(header, fileSize);
+
+    BOOST_CHECK(isValid);
+    BOOST_CHECK(!isSwappedValid);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
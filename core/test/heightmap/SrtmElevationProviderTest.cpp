@@ -2,6 +2,7 @@
 
 #include "config.hpp"
 #include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
 
 using namespace utymap;
 using namespace utymap::heightmap;
@@ -17,4 +18,46 @@ BOOST_AUTO_TEST_CASE(GivenTestLocation_WhenGetElevation_ThenReturnExpectedIntege
     BOOST_CHECK_CLOSE(ele, 34.853, 0.01);
 }
 
+BOOST_AUTO_TEST_CASE(GivenTestLocations_WhenGetElevations_ThenReturnSameHeightsAsSingleCalls)
+{
+    SrtmElevationProvider eleProvider(TEST_ASSETS_PATH);
+    QuadKey quadKey(16, 35205, 21489);
+    const double latitudes[] = { 52.5317429, 52.5320, 52.5310 };
+    const double longitudes[] = { 13.3871987, 13.3880, 13.3860 };
+    double elevations[3];
+
+    eleProvider.getElevations(quadKey, latitudes, longitudes, elevations, 3);
+
+    for (std::size_t i = 0; i < 3; ++i)
+        BOOST_CHECK_EQUAL(elevations[i], eleProvider.getElevation(quadKey, latitudes[i], longitudes[i]));
+    BOOST_CHECK_CLOSE(elevations[0], 34.853, 0.01);
+}
+
+BOOST_AUTO_TEST_CASE(GivenCacheSizeLimit_WhenGetElevationsFromDifferentCells_ThenCacheSizeIsBounded)
+{
+    // NOTE use copies of the same hgt file as different cells.
+    namespace fs = boost::filesystem;
+    fs::path directory = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directories(directory);
+    fs::copy_file(fs::path(TEST_ASSETS_PATH) / "N52E013.hgt", directory / "N52E013.hgt");
+    fs::copy_file(fs::path(TEST_ASSETS_PATH) / "N52E013.hgt", directory / "N52E014.hgt");
+    QuadKey quadKey(16, 35205, 21489);
+    double first, second, third;
+    std::size_t cacheSize;
+    {
+        SrtmElevationProvider eleProvider(directory.string() + "/", 1);
+
+        first = eleProvider.getElevation(quadKey, 52.5317429, 13.3871987);
+        second = eleProvider.getElevation(quadKey, 52.5317429, 14.3871987);
+        third = eleProvider.getElevation(quadKey, 52.5317429, 13.3871987);
+        cacheSize = eleProvider.getCacheSize();
+    }
+    fs::remove_all(directory);
+
+    BOOST_CHECK_EQUAL(cacheSize, 1);
+    BOOST_CHECK_CLOSE(first, 34.853, 0.01);
+    BOOST_CHECK_EQUAL(first, second);
+    BOOST_CHECK_EQUAL(first, third);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
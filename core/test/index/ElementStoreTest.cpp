@@ -25,8 +25,8 @@ namespace {
     public:
         int times;
 
-        TestElementStore(StringTable& stringTable, StoreCallback function) :
-            ElementStore(stringTable),
+        TestElementStore(StringTable& stringTable, StoreCallback function, std::size_t clipThreads = 0) :
+            ElementStore(stringTable, clipThreads),
             times(0),
             function_(function)
         {
@@ -34,6 +34,8 @@ namespace {
 
         void search(const QuadKey&, ElementVisitor&) override { }
 
+        void search(const GeoCoordinate&, double, ElementVisitor&) override { }
+
         bool hasData(const QuadKey&) const override { return true; }
 
         void commit() override {}
@@ -45,6 +47,8 @@ namespace {
             times++;
             function_(element, quadKey);
         }
+
+        void storeSpatialImpl(const Element&, const BoundingBox&) override { }
     private:
         StoreCallback function_;
     };
@@ -304,4 +308,32 @@ BOOST_AUTO_TEST_CASE(GivenWay_WhenStoreInsideQuadKey_IsStored)
     BOOST_CHECK_EQUAL(elementStore.times, 1);
 }
 
+BOOST_AUTO_TEST_CASE(GivenAreaInManyTiles_WhenStoreConcurrently_ThenResultIsSameAsSequential)
+{
+    Area area = ElementUtils::createElement<Area>(*dependencyProvider.getStringTable(), 0,
+        { { "test", "Foo" } },
+        { { 10, 10 }, { 10, -10 }, { 20, -10 }, { 20, 10 } });
+    auto styleProvider = dependencyProvider.getStyleProvider("area|z7[test=Foo] { key:val; clip: true;}");
+    std::vector<std::pair<QuadKey, std::size_t>> sequential, concurrent;
+    TestElementStore sequentialStore(*dependencyProvider.getStringTable(),
+        [&](const Element& element, const QuadKey& quadKey) {
+        sequential.push_back(std::make_pair(quadKey, static_cast<const Area&>(element).coordinates.size()));
+    });
+    TestElementStore concurrentStore(*dependencyProvider.getStringTable(),
+        [&](const Element& element, const QuadKey& quadKey) {
+        concurrent.push_back(std::make_pair(quadKey, static_cast<const Area&>(element).coordinates.size()));
+    }, 4);
+
+    sequentialStore.store(area, LodRange(7, 7), *styleProvider);
+    concurrentStore.store(area, LodRange(7, 7), *styleProvider);
+
+    BOOST_CHECK_GT(sequential.size(), 8);
+    BOOST_REQUIRE_EQUAL(concurrent.size(), sequential.size());
+    for (std::size_t i = 0; i < sequential.size(); ++i) {
+        BOOST_CHECK(checkQuadKey(concurrent[i].first, sequential[i].first.levelOfDetail,
+                                 sequential[i].first.tileX, sequential[i].first.tileY));
+        BOOST_CHECK_EQUAL(concurrent[i].second, sequential[i].second);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,179 @@
+#include "QuadKey.hpp"
+#include "entities/Node.hpp"
+#include "entities/Way.hpp"
+#include "index/GeoStore.hpp"
+#include "index/InMemoryElementStore.hpp"
+#include "mapcss/MapCssParser.hpp"
+#include "utils/CoreUtils.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include "test_utils/DependencyProvider.hpp"
+#include "test_utils/ElementUtils.hpp"
+
+using namespace utymap;
+using namespace utymap::entities;
+using namespace utymap::index;
+using namespace utymap::mapcss;
+using namespace utymap::tests;
+
+namespace {
+    const std::string stylesheet = "way|z1[any],node|z1[any] { clip: false; }";
+    const std::string searchStylesheet = "way|z1[none] { clip: false; }";
+
+    struct Index_GeoStoreFixture
+    {
+        Index_GeoStoreFixture() :
+            dependencyProvider(),
+            styleProvider(dependencyProvider.getStyleProvider(stylesheet)),
+            searchStyleProvider(MapCssParser().parse(searchStylesheet), *dependencyProvider.getStringTable())
+        {
+        }
+
+        /// Fills given geo store with stores which have overlapping elements.
+        void fill(GeoStore& geoStore, int storeCount)
+        {
+            LodRange range(1, 1);
+            for (int i = 0; i < storeCount; ++i) {
+                std::string storeKey = "store" + std::to_string(i);
+                geoStore.registerStore(storeKey,
+                    utymap::utils::make_unique<InMemoryElementStore>(*dependencyProvider.getStringTable()));
+
+                // NOTE the first way is shared by all stores.
+                geoStore.add(storeKey, createWay(1), range, *styleProvider);
+                geoStore.add(storeKey, createWay(100 + i), range, *styleProvider);
+            }
+        }
+
+        Way createWay(std::uint64_t id)
+        {
+            return ElementUtils::createElement<Way>(*dependencyProvider.getStringTable(), id,
+                { { "any", "true" } }, { { 5, -5 }, { 5, -10 } });
+        }
+
+        DependencyProvider dependencyProvider;
+        std::shared_ptr<StyleProvider> styleProvider;
+        StyleProvider searchStyleProvider;
+    };
+
+    struct ElementCounter : public ElementVisitor
+    {
+        int times = 0;
+
+        void visitNode(const Node&) override { ++times; }
+        void visitWay(const Way&) override { ++times; }
+        void visitArea(const Area&) override { ++times; }
+        void visitRelation(const Relation&) override { ++times; }
+    };
+}
+
+BOOST_FIXTURE_TEST_SUITE(Index_GeoStore, Index_GeoStoreFixture)
+
+BOOST_AUTO_TEST_CASE(GivenOverlappingStores_WhenSearchSequentially_ThenDuplicatesAreSkipped)
+{
+    GeoStore geoStore(*dependencyProvider.getStringTable());
+    fill(geoStore, 4);
+    ElementCounter counter;
+
+    geoStore.search(QuadKey(1, 0, 0), searchStyleProvider, counter);
+
+    BOOST_CHECK_EQUAL(counter.times, 5);
+}
+
+BOOST_AUTO_TEST_CASE(GivenOverlappingStores_WhenSearchConcurrently_ThenDuplicatesAreSkipped)
+{
+    GeoStore geoStore(*dependencyProvider.getStringTable(), 4);
+    fill(geoStore, 4);
+    ElementCounter counter;
+
+    geoStore.search(QuadKey(1, 0, 0), searchStyleProvider, counter);
+
+    BOOST_CHECK_EQUAL(counter.times, 5);
+}
+
+BOOST_AUTO_TEST_CASE(GivenStyledDuplicates_WhenSearchConcurrently_ThenResultIsSameAsSequential)
+{
+    GeoStore sequentialStore(*dependencyProvider.getStringTable());
+    GeoStore concurrentStore(*dependencyProvider.getStringTable(), 2);
+    fill(sequentialStore, 3);
+    fill(concurrentStore, 3);
+    ElementCounter sequentialCounter, concurrentCounter;
+
+    sequentialStore.search(QuadKey(1, 0, 0), *styleProvider, sequentialCounter);
+    concurrentStore.search(QuadKey(1, 0, 0), *styleProvider, concurrentCounter);
+
+    BOOST_CHECK_EQUAL(concurrentCounter.times, sequentialCounter.times);
+}
+
+BOOST_AUTO_TEST_CASE(GivenOverlappingStores_WhenSearchInRadius_ThenEveryElementIsVisitedOnce)
+{
+    GeoStore geoStore(*dependencyProvider.getStringTable());
+    fill(geoStore, 3);
+    ElementCounter counter;
+
+    geoStore.search(GeoCoordinate(5, -7), 1000, searchStyleProvider, counter);
+
+    BOOST_CHECK_EQUAL(counter.times, 4);
+}
+
+BOOST_AUTO_TEST_CASE(GivenStyledDuplicates_WhenSearchInRadius_ThenResultIsSameAsQuadKeySearch)
+{
+    GeoStore geoStore(*dependencyProvider.getStringTable());
+    fill(geoStore, 3);
+    ElementCounter quadKeyCounter, radiusCounter;
+
+    geoStore.search(QuadKey(1, 0, 0), *styleProvider, quadKeyCounter);
+    geoStore.search(GeoCoordinate(5, -7), 1000, *styleProvider, radiusCounter);
+
+    BOOST_CHECK_EQUAL(radiusCounter.times, quadKeyCounter.times);
+    BOOST_CHECK_GT(radiusCounter.times, 4);
+}
+
+BOOST_AUTO_TEST_CASE(GivenCache_WhenSearchTwice_ThenSecondSearchHitsCache)
+{
+    GeoStore geoStore(*dependencyProvider.getStringTable(), 0, 1024 * 1024);
+    fill(geoStore, 2);
+    ElementCounter first, second;
+
+    geoStore.search(QuadKey(1, 0, 0), searchStyleProvider, first);
+    geoStore.search(QuadKey(1, 0, 0), searchStyleProvider, second);
+
+    BOOST_CHECK_EQUAL(first.times, 3);
+    BOOST_CHECK_EQUAL(second.times, 3);
+    auto statistics = geoStore.getCacheStatistics();
+    BOOST_CHECK_EQUAL(statistics.misses, 2);
+    BOOST_CHECK_EQUAL(statistics.hits, 2);
+    BOOST_CHECK_EQUAL(statistics.entries, 2);
+}
+
+BOOST_AUTO_TEST_CASE(GivenCachedTile_WhenAddElement_ThenTileIsInvalidated)
+{
+    GeoStore geoStore(*dependencyProvider.getStringTable(), 0, 1024 * 1024);
+    fill(geoStore, 1);
+    ElementCounter first, second;
+
+    geoStore.search(QuadKey(1, 0, 0), searchStyleProvider, first);
+    geoStore.add("store0", createWay(200), LodRange(1, 1), *styleProvider);
+    geoStore.search(QuadKey(1, 0, 0), searchStyleProvider, second);
+
+    BOOST_CHECK_EQUAL(first.times, 2);
+    BOOST_CHECK_EQUAL(second.times, 3);
+    BOOST_CHECK_EQUAL(geoStore.getCacheStatistics().hits, 0);
+}
+
+BOOST_AUTO_TEST_CASE(GivenSmallCache_WhenSearchManyTiles_ThenSizeIsBounded)
+{
+    const std::size_t cacheSize = 1024;
+    GeoStore geoStore(*dependencyProvider.getStringTable(), 0, cacheSize);
+    fill(geoStore, 1);
+    ElementCounter counter;
+
+    for (int x = 0; x < 2; ++x)
+        for (int y = 0; y < 2; ++y)
+            geoStore.search(QuadKey(1, x, y), searchStyleProvider, counter);
+
+    BOOST_CHECK_EQUAL(counter.times, 2);
+    BOOST_CHECK_LE(geoStore.getCacheStatistics().size, cacheSize);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
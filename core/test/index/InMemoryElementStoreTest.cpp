@@ -77,4 +77,22 @@ BOOST_AUTO_TEST_CASE(GivenNodeWayArea_WhenSearch_ThenAllSkipped)
     BOOST_CHECK_EQUAL(counter.times, 0);
 }
 
+BOOST_AUTO_TEST_CASE(GivenNodeWayArea_WhenSearchInRadius_ThenOnlyCloseElementsFound)
+{
+    ElementCounter counter;
+
+    elementStore.search(GeoCoordinate(5, -5), 1000, counter);
+
+    BOOST_CHECK_EQUAL(counter.times, 3);
+}
+
+BOOST_AUTO_TEST_CASE(GivenNodeWayArea_WhenSearchInRadiusFarAway_ThenNothingFound)
+{
+    ElementCounter counter;
+
+    elementStore.search(GeoCoordinate(4, -4), 1000, counter);
+
+    BOOST_CHECK_EQUAL(counter.times, 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -10,6 +10,8 @@
 
 #include <boost/filesystem/operations.hpp>
 #include <cstdio>
+#include <fstream>
+#include <functional>
 
 using namespace utymap;
 using namespace utymap::entities;
@@ -19,6 +21,9 @@ using namespace utymap::tests;
 
 namespace {
     const std::string TestZoomDirectory = "1";
+    const std::string TestManifestFile = "manifest.idx";
+    const std::string TestSpatialIndexFile = "spatial.idf";
+    const std::string TestSpatialDataFile = "spatial.dat";
 
     const std::string stylesheet = "node|z1[any], way|z1[any], area|z1[any], relation|z1[any] { clip: false; }";
 
@@ -40,6 +45,9 @@ namespace {
                 boost::filesystem::remove_all(it->path());
             }
             boost::filesystem::remove(TestZoomDirectory);
+            boost::filesystem::remove(TestManifestFile);
+            boost::filesystem::remove(TestSpatialIndexFile);
+            boost::filesystem::remove(TestSpatialDataFile);
         }
 
         DependencyProvider dependencyProvider;
@@ -50,17 +58,20 @@ namespace {
     {
         int times = 0;
         std::shared_ptr<Element> element;
+        std::function<void(const Element&)> callback;
 
         void visitNode(const Node& node) override
         { 
             ++times; 
             element = std::make_shared<Node>(node);
+            if (callback) callback(node);
         }
 
         void visitWay(const Way& way) override
         {
             ++times;
             element = std::make_shared<Way>(way);
+            if (callback) callback(way);
         }
         void visitArea(const Area& area) override
         {
@@ -199,4 +210,253 @@ BOOST_AUTO_TEST_CASE(GivenTwoAreas_WhenStoreAndSearchOnce_ThenTheyStoredTwiceAnd
     assertWayOrArea(area2, *std::dynamic_pointer_cast<Area>(counter.element));
 }
 
-BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
+BOOST_AUTO_TEST_CASE(GivenWay_WhenStoreAndSearchWithStreamReadMode_ThenItIsStoredAndReadBack)
+{
+    LodRange range(1, 2);
+    QuadKey quadKey(1, 0, 0);
+    auto styleProvider = dependencyProvider.getStyleProvider(stylesheet);
+    Way way = ElementUtils::createElement<Way>(*dependencyProvider.getStringTable(), 7, { { "any", "true" } }, { { 1, -1 }, { 5, -5 } });
+    ElementCounter counter;
+
+    elementStore.store(way, range, *styleProvider);
+    elementStore.commit();
+    PersistentElementStore streamElementStore("", *dependencyProvider.getStringTable(), PersistentElementStore::ReadMode::Stream);
+    streamElementStore.search(quadKey, counter);
+    streamElementStore.commit();
+
+    BOOST_CHECK_EQUAL(counter.times, 1);
+    assertWayOrArea(way, *std::dynamic_pointer_cast<Way>(counter.element));
+}
+
+BOOST_AUTO_TEST_CASE(GivenTwoWaysWithDifferentSizes_WhenStoreAndSearch_ThenBothAreReadBackIndependently)
+{
+    LodRange range(1, 2);
+    QuadKey quadKey(1, 0, 0);
+    auto styleProvider = dependencyProvider.getStyleProvider(stylesheet);
+    Way way1 = ElementUtils::createElement<Way>(*dependencyProvider.getStringTable(), 1,
+        { { "any", "true" }, { "highway", "primary" } }, { { 1, -1 }, { 2, -2 }, { 3, -3 } });
+    Way way2 = ElementUtils::createElement<Way>(*dependencyProvider.getStringTable(), 2,
+        { { "any", "true" } }, { { 4, -4 }, { 5, -5 } });
+    std::vector<Way> ways;
+    ElementCounter counter;
+    counter.callback = [&](const Element& element) { ways.push_back(static_cast<const Way&>(element)); };
+
+    elementStore.store(way1, range, *styleProvider);
+    elementStore.store(way2, range, *styleProvider);
+    elementStore.commit();
+    elementStore.search(quadKey, counter);
+
+    BOOST_CHECK_EQUAL(ways.size(), 2);
+    assertWayOrArea(way1, ways[0]);
+    assertWayOrArea(way2, ways[1]);
+}
+
+BOOST_AUTO_TEST_CASE(GivenSmallBufferAndOneOpenFile_WhenStoreInDifferentQuadKeys_ThenAllAreReadBack)
+{
+    LodRange range(1, 1);
+    auto styleProvider = dependencyProvider.getStyleProvider(stylesheet);
+    PersistentElementStore bufferedElementStore("", *dependencyProvider.getStringTable(),
+        PersistentElementStore::ReadMode::Mapped, 1, 1);
+    std::vector<GeoCoordinate> coordinates = { { 5, -5 }, { 5, 5 }, { -5, -5 }, { 5, -6 }, { -5, 5 } };
+    std::vector<QuadKey> quadKeys = { QuadKey(1, 0, 0), QuadKey(1, 1, 0), QuadKey(1, 0, 1), QuadKey(1, 1, 1) };
+    for (std::size_t i = 0; i < coordinates.size(); ++i) {
+        Node node = ElementUtils::createElement<Node>(*dependencyProvider.getStringTable(), i + 1, { { "any", "true" } });
+        node.coordinate = coordinates[i];
+        bufferedElementStore.store(node, range, *styleProvider);
+    }
+    bufferedElementStore.commit();
+
+    std::vector<int> counts;
+    for (const auto& quadKey : quadKeys) {
+        ElementCounter counter;
+        bufferedElementStore.search(quadKey, counter);
+        counts.push_back(counter.times);
+    }
+
+    std::vector<int> expected = { 2, 1, 1, 1 };
+    BOOST_CHECK_EQUAL_COLLECTIONS(counts.begin(), counts.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(GivenNotCommittedElement_WhenSearch_ThenItIsReturned)
+{
+    LodRange range(1, 1);
+    QuadKey quadKey(1, 0, 0);
+    auto styleProvider = dependencyProvider.getStyleProvider(stylesheet);
+    Node node = ElementUtils::createElement<Node>(*dependencyProvider.getStringTable(), 7, { { "any", "true" } });
+    node.coordinate = { 5, -5 };
+    ElementCounter counter;
+
+    elementStore.store(node, range, *styleProvider);
+
+    BOOST_CHECK(elementStore.hasData(quadKey));
+    elementStore.search(quadKey, counter);
+    BOOST_CHECK_EQUAL(counter.times, 1);
+}
+
+BOOST_AUTO_TEST_CASE(GivenWayWithFractionalCoordinates_WhenStoreAndSearch_ThenFixedPointPrecisionIsKept)
+{
+    LodRange range(1, 1);
+    QuadKey quadKey(1, 0, 0);
+    auto styleProvider = dependencyProvider.getStyleProvider(stylesheet);
+    Way way = ElementUtils::createElement<Way>(*dependencyProvider.getStringTable(), 7, { { "any", "true" } },
+        { { 52.5200066, -13.4049540 }, { 52.5200067, -13.4049541 }, { 1.0000001, -179.9999999 } });
+    ElementCounter counter;
+
+    elementStore.store(way, range, *styleProvider);
+    elementStore.commit();
+    elementStore.search(quadKey, counter);
+
+    const auto& result = *std::dynamic_pointer_cast<Way>(counter.element);
+    BOOST_CHECK_EQUAL(result.coordinates.size(), way.coordinates.size());
+    for (std::size_t i = 0; i < way.coordinates.size(); ++i) {
+        BOOST_CHECK_SMALL(result.coordinates[i].latitude - way.coordinates[i].latitude, 1E-9);
+        BOOST_CHECK_SMALL(result.coordinates[i].longitude - way.coordinates[i].longitude, 1E-9);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(GivenVersionOneFiles_WhenStoreAndSearch_ThenOldAndNewElementsAreReadBack)
+{
+    LodRange range(1, 1);
+    QuadKey quadKey(1, 0, 0);
+    auto styleProvider = dependencyProvider.getStyleProvider(stylesheet);
+    Tag tag = ElementUtils::createTag(*dependencyProvider.getStringTable(), "any", "true");
+    {
+        // write node in version 1 format which has no header
+        std::ofstream dataFile(TestZoomDirectory + "/0.dat", std::ios::binary);
+        std::uint8_t flags = 0;
+        std::uint16_t tagSize = 1;
+        double latitude = 5, longitude = -5;
+        dataFile.write(reinterpret_cast<const char*>(&flags), sizeof(flags));
+        dataFile.write(reinterpret_cast<const char*>(&tagSize), sizeof(tagSize));
+        dataFile.write(reinterpret_cast<const char*>(&tag.key), sizeof(tag.key));
+        dataFile.write(reinterpret_cast<const char*>(&tag.value), sizeof(tag.value));
+        dataFile.write(reinterpret_cast<const char*>(&latitude), sizeof(latitude));
+        dataFile.write(reinterpret_cast<const char*>(&longitude), sizeof(longitude));
+
+        std::ofstream indexFile(TestZoomDirectory + "/0.idf", std::ios::binary);
+        std::uint64_t id = 1;
+        std::uint32_t offset = 0;
+        indexFile.write(reinterpret_cast<const char*>(&id), sizeof(id));
+        indexFile.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+    }
+    // NOTE version 1 stores have no manifest: it is built from data files.
+    boost::filesystem::remove(TestManifestFile);
+    PersistentElementStore oldElementStore("", *dependencyProvider.getStringTable());
+    Node node = ElementUtils::createElement<Node>(*dependencyProvider.getStringTable(), 2, { { "any", "true" } });
+    node.coordinate = { 10, -10 };
+    std::vector<Node> nodes;
+    ElementCounter counter;
+    counter.callback = [&](const Element& element) { nodes.push_back(static_cast<const Node&>(element)); };
+
+    BOOST_CHECK(oldElementStore.hasData(quadKey));
+    oldElementStore.store(node, range, *styleProvider);
+    oldElementStore.commit();
+    oldElementStore.search(quadKey, counter);
+
+    BOOST_CHECK_EQUAL(nodes.size(), 2);
+    BOOST_CHECK_EQUAL(nodes[0].id, 1);
+    BOOST_CHECK_EQUAL(nodes[0].tags.size(), 1);
+    assertGeometry(GeoCoordinate(5, -5), nodes[0].coordinate);
+    assertNode(node, nodes[1]);
+}
+
+BOOST_AUTO_TEST_CASE(GivenNoData_WhenSearch_ThenNothingIsReturned)
+{
+    ElementCounter counter;
+
+    elementStore.search(QuadKey(1, 1, 1), counter);
+
+    BOOST_CHECK_EQUAL(counter.times, 0);
+}
+
+BOOST_AUTO_TEST_CASE(GivenCommittedNode_WhenReopenStore_ThenHasDataUsesManifest)
+{
+    LodRange range(1, 1);
+    auto styleProvider = dependencyProvider.getStyleProvider(stylesheet);
+    Node node = ElementUtils::createElement<Node>(*dependencyProvider.getStringTable(), 7, { { "any", "true" } });
+    node.coordinate = { 5, -5 };
+
+    elementStore.store(node, range, *styleProvider);
+    elementStore.commit();
+    PersistentElementStore reopenedElementStore("", *dependencyProvider.getStringTable());
+
+    BOOST_CHECK(reopenedElementStore.hasData(QuadKey(1, 0, 0)));
+    BOOST_CHECK(!reopenedElementStore.hasData(QuadKey(1, 1, 0)));
+    BOOST_CHECK(!reopenedElementStore.hasData(QuadKey(2, 0, 0)));
+}
+
+BOOST_AUTO_TEST_CASE(GivenNodes_WhenSearchInRadiusAfterReopen_ThenOnlyCloseNodesFound)
+{
+    LodRange range(1, 1);
+    auto styleProvider = dependencyProvider.getStyleProvider(stylesheet);
+    std::vector<GeoCoordinate> coordinates = { { 52.52, 13.40 }, { 52.521, 13.401 }, { 52.6, 13.5 } };
+    for (std::size_t i = 0; i < coordinates.size(); ++i) {
+        Node node = ElementUtils::createElement<Node>(*dependencyProvider.getStringTable(), i + 1, { { "any", "true" } });
+        node.coordinate = coordinates[i];
+        elementStore.store(node, range, *styleProvider);
+    }
+    ElementCounter counter, reopenedCounter;
+    std::vector<std::uint64_t> ids;
+    reopenedCounter.callback = [&](const Element& element) { ids.push_back(element.id); };
+
+    elementStore.search(GeoCoordinate(52.52, 13.40), 500, counter);
+    elementStore.commit();
+    PersistentElementStore reopenedElementStore("", *dependencyProvider.getStringTable());
+    reopenedElementStore.search(GeoCoordinate(52.52, 13.40), 500, reopenedCounter);
+
+    BOOST_CHECK_EQUAL(counter.times, 2);
+    std::vector<std::uint64_t> expected = { 1, 2 };
+    BOOST_CHECK_EQUAL_COLLECTIONS(ids.begin(), ids.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(GivenNotClippedNodes_WhenCommit_ThenSpatialDataIsNotDuplicated)
+{
+    auto styleProvider = dependencyProvider.getStyleProvider(stylesheet);
+    Node node = ElementUtils::createElement<Node>(*dependencyProvider.getStringTable(), 1, { { "any", "true" } });
+    node.coordinate = GeoCoordinate(52.52, 13.40);
+
+    elementStore.store(node, LodRange(1, 1), *styleProvider);
+    elementStore.commit();
+
+    BOOST_CHECK(boost::filesystem::exists(TestSpatialIndexFile));
+    BOOST_CHECK(!boost::filesystem::exists(TestSpatialDataFile));
+}
+
+BOOST_AUTO_TEST_CASE(GivenDataWithoutSpatialIndex_WhenSearchInRadius_ThenIndexIsRebuilt)
+{
+    auto styleProvider = dependencyProvider.getStyleProvider(stylesheet);
+    std::vector<GeoCoordinate> coordinates = { { 52.52, 13.40 }, { 52.521, 13.401 }, { 52.6, 13.5 } };
+    for (std::size_t i = 0; i < coordinates.size(); ++i) {
+        Node node = ElementUtils::createElement<Node>(*dependencyProvider.getStringTable(), i + 1, { { "any", "true" } });
+        node.coordinate = coordinates[i];
+        elementStore.store(node, LodRange(1, 1), *styleProvider);
+    }
+    elementStore.commit();
+    boost::filesystem::remove(TestSpatialIndexFile);
+    ElementCounter counter;
+
+    PersistentElementStore reopenedElementStore("", *dependencyProvider.getStringTable());
+    reopenedElementStore.search(GeoCoordinate(52.52, 13.40), 500, counter);
+
+    BOOST_CHECK_EQUAL(counter.times, 2);
+    BOOST_CHECK(boost::filesystem::exists(TestSpatialIndexFile));
+}
+
+BOOST_AUTO_TEST_CASE(GivenClippedWay_WhenSearchInRadiusAfterReopen_ThenOriginalGeometryIsReturned)
+{
+    auto styleProvider = dependencyProvider.getStyleProvider("way|z1[any] { clip: true; }");
+    Way way = ElementUtils::createElement<Way>(*dependencyProvider.getStringTable(), 1, { { "any", "true" } });
+    way.coordinates = { { 10, -10 }, { 10, 10 } };
+    elementStore.store(way, LodRange(1, 1), *styleProvider);
+    elementStore.commit();
+    ElementCounter counter;
+
+    PersistentElementStore reopenedElementStore("", *dependencyProvider.getStringTable());
+    reopenedElementStore.search(GeoCoordinate(10, 0), 1000, counter);
+
+    BOOST_CHECK(boost::filesystem::exists(TestSpatialDataFile));
+    BOOST_REQUIRE_EQUAL(counter.times, 1);
+    assertGeometry(way.coordinates, static_cast<const Way&>(*counter.element).coordinates);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
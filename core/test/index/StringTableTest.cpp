@@ -4,6 +4,8 @@
 #include "test_utils/DependencyProvider.hpp"
 
 #include <cstdio>
+#include <thread>
+#include <vector>
 
 using namespace utymap::index;
 using namespace utymap::tests;
@@ -57,4 +59,55 @@ BOOST_AUTO_TEST_CASE(GivenThreeStrings_WhenGetStringOfSecond_ThenReturnValidStri
     BOOST_CHECK_EQUAL( str, "string2" );
 }
 
+BOOST_AUTO_TEST_CASE(GivenStoredStrings_WhenReopen_ThenIdsAndStringsArePreserved)
+{
+    {
+        StringTable stringTable("");
+        stringTable.getId("string1");
+        stringTable.getId("string2");
+    }
+
+    StringTable stringTable("");
+
+    BOOST_CHECK_EQUAL(stringTable.getId("string2"), 1);
+    BOOST_CHECK_EQUAL(stringTable.getString(0), "string1");
+    BOOST_CHECK_EQUAL(stringTable.getId("string3"), 2);
+    BOOST_CHECK_EQUAL(stringTable.getString(2), "string3");
+}
+
+BOOST_AUTO_TEST_CASE(GivenManyStrings_WhenGetIdFromDifferentThreads_ThenIdsAreConsistent)
+{
+    const int ThreadCount = 4;
+    const int StringCount = 10000;
+    auto stringTable = dependencyProvider.getStringTable();
+    std::vector<std::vector<std::uint32_t>> ids(ThreadCount);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < ThreadCount; ++t) {
+        threads.push_back(std::thread([&, t]() {
+            for (int i = 0; i < StringCount; ++i)
+                ids[t].push_back(stringTable->getId("string" + std::to_string(i)));
+        }));
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    for (int t = 1; t < ThreadCount; ++t)
+        BOOST_CHECK(ids[t] == ids[0]);
+    for (int i = 0; i < StringCount; ++i)
+        BOOST_CHECK_EQUAL(stringTable->getString(ids[0][i]), "string" + std::to_string(i));
+}
+
+BOOST_AUTO_TEST_CASE(GivenNumericAndTextStrings_WhenGetNumber_ThenReturnParsedValueOrZero)
+{
+    auto& stringTable = *dependencyProvider.getStringTable();
+    std::uint32_t integer = stringTable.getId("12");
+    std::uint32_t real = stringTable.getId("-2.5");
+    std::uint32_t text = stringTable.getId("12m");
+
+    BOOST_CHECK_EQUAL(stringTable.getNumber(integer), 12);
+    BOOST_CHECK_EQUAL(stringTable.getNumber(real), -2.5);
+    BOOST_CHECK_EQUAL(stringTable.getNumber(text), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -75,4 +75,27 @@ BOOST_AUTO_TEST_CASE(GiveOneTagOneNumber_WhenStringEvaluate_ThenReturnValue)
     BOOST_CHECK_EQUAL(result, "red");
 }
 
+BOOST_AUTO_TEST_CASE(GivenCompiledExpression_WhenDoubleEvaluate_ThenReturnValue)
+{
+    auto& stringTable = *dependencyProvider.getStringTable();
+    StyleDeclaration styleDeclaration(0, "eval(\"-tag('min_height') + tag('building:levels') * 3 / 2\")", stringTable);
+
+    double result = styleDeclaration.evaluate<double>(ElementUtils::createElement<Node>(stringTable,
+        0, { { "min_height", "3" }, { "building:levels", "5" } }).tags, stringTable);
+
+    BOOST_CHECK(styleDeclaration.isEval());
+    BOOST_CHECK_CLOSE(result, 4.5, 1E-9);
+}
+
+BOOST_AUTO_TEST_CASE(GivenCompiledExpression_WhenStringEvaluate_ThenReturnValue)
+{
+    auto& stringTable = *dependencyProvider.getStringTable();
+    StyleDeclaration styleDeclaration(0, "eval(\"tag('color')\")", stringTable);
+
+    std::string result = styleDeclaration.evaluate<std::string>(ElementUtils::createElement<Node>(stringTable,
+        0, { { "color", "red" } }).tags, stringTable);
+
+    BOOST_CHECK_EQUAL(result, "red");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
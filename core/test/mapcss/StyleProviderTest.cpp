@@ -8,6 +8,9 @@
 #include <boost/test/unit_test.hpp>
 #include "test_utils/DependencyProvider.hpp"
 
+#include <future>
+#include <vector>
+
 using namespace utymap::entities;
 using namespace utymap::mapcss;
 using namespace utymap::tests;
@@ -94,6 +97,20 @@ BOOST_AUTO_TEST_CASE(GivenSimpleGreaterCondition_WhenHasStyle_ThenReturnsExpecte
         zoomLevel));
 }
 
+BOOST_AUTO_TEST_CASE(GivenGreaterConditionAndNonNumericValue_WhenHasStyleTwice_ThenReturnsFalse)
+{
+    int zoomLevel = 1;
+    setSingleSelector(zoomLevel, zoomLevel, { "way" }, { { "building:levels", ">", "5" } });
+    StyleProvider provider(*stylesheet, *dependencyProvider.getStringTable(), 0);
+    Way way = ElementUtils::createElement<Way>(*dependencyProvider.getStringTable(), 0, { { "building:levels", "many" } });
+
+    BOOST_CHECK(!provider.hasStyle(way, zoomLevel));
+    BOOST_CHECK(!provider.hasStyle(way, zoomLevel));
+    BOOST_CHECK(provider.hasStyle(
+        ElementUtils::createElement<Way>(*dependencyProvider.getStringTable(), 0, { { "building:levels", "7" } }),
+        zoomLevel));
+}
+
 BOOST_AUTO_TEST_CASE(GivenTwoNamesAndSimpleEqualsCondition_WhenHasStyleForSecondName_ThenReturnTrue)
 {
     int zoomLevel = 1;
@@ -170,4 +187,107 @@ BOOST_AUTO_TEST_CASE(GivenCustomElementRuleOverridesDefault_WhenForElement_ThenS
     BOOST_CHECK(!style.has(dependencyProvider.getStringTable()->getId("key1")));
 }
 
+BOOST_AUTO_TEST_CASE(GivenRulesIndexedByDifferentTags_WhenForElement_ThenLaterRuleOverridesEarlier)
+{
+    int zoomLevel = 1;
+    setSingleSelector(zoomLevel, zoomLevel, { "node" }, { {"amenity", "=", "biergarten"} }, { {"key1", "value1"} });
+    setSingleSelector(zoomLevel, zoomLevel, { "node" }, { {"name", "", ""} }, { {"key1", "value2"} });
+    setSingleSelector(zoomLevel, zoomLevel, { "node" }, { {"amenity", "=", "pub"} }, { {"key1", "value3"} });
+    auto& stringTable = *dependencyProvider.getStringTable();
+    Node node = ElementUtils::createElement<Node>(stringTable, 1,
+        { std::make_pair("amenity", "biergarten"), std::make_pair("name", "Prater") });
+
+    Style style = styleProvider->forElement(node, zoomLevel);
+
+    BOOST_CHECK(style.has(stringTable.getId("key1"), "value2"));
+}
+
+BOOST_AUTO_TEST_CASE(GivenElementsWithSameTags_WhenForElement_ThenStyleIsResolvedOnce)
+{
+    int zoomLevel = 1;
+    setSingleSelector(zoomLevel, zoomLevel, { "node" },
+                      { {"amenity", "=", "biergarten"} },
+                      { {"key1", "value1"} });
+    auto& stringTable = *dependencyProvider.getStringTable();
+    Node node1 = ElementUtils::createElement<Node>(stringTable, 1, { std::make_pair("amenity", "biergarten") });
+    Node node2 = ElementUtils::createElement<Node>(stringTable, 2, { std::make_pair("amenity", "biergarten") });
+
+    BOOST_CHECK(styleProvider->hasStyle(node1, zoomLevel));
+    Style style1 = styleProvider->forElement(node1, zoomLevel);
+    Style style2 = styleProvider->forElement(node2, zoomLevel);
+
+    auto statistics = styleProvider->getCacheStatistics();
+    BOOST_CHECK(style1.has(stringTable.getId("key1"), "value1"));
+    BOOST_CHECK(style2.has(stringTable.getId("key1"), "value1"));
+    BOOST_CHECK_EQUAL(statistics.misses, 1);
+    BOOST_CHECK_EQUAL(statistics.hits, 2);
+    BOOST_CHECK_EQUAL(statistics.entries, 1);
+}
+
+BOOST_AUTO_TEST_CASE(GivenSameTagsOnDifferentElementTypes_WhenForElement_ThenStylesAreResolvedSeparately)
+{
+    int zoomLevel = 1;
+    setSingleSelector(zoomLevel, zoomLevel, { "node" },
+                      { {"amenity", "=", "biergarten"} },
+                      { {"key1", "value1"} });
+    auto& stringTable = *dependencyProvider.getStringTable();
+    Node node = ElementUtils::createElement<Node>(stringTable, 1, { std::make_pair("amenity", "biergarten") });
+    Way way = ElementUtils::createElement<Way>(stringTable, 2, { std::make_pair("amenity", "biergarten") });
+
+    BOOST_CHECK(styleProvider->hasStyle(node, zoomLevel));
+    BOOST_CHECK(!styleProvider->hasStyle(way, zoomLevel));
+    BOOST_CHECK(!styleProvider->forElement(way, zoomLevel).has(stringTable.getId("key1")));
+
+    BOOST_CHECK_EQUAL(styleProvider->getCacheStatistics().entries, 2);
+}
+
+BOOST_AUTO_TEST_CASE(GivenDisabledCache_WhenForElement_ThenStyleIsResolved)
+{
+    int zoomLevel = 1;
+    setSingleSelector(zoomLevel, zoomLevel, { "node" },
+                      { {"amenity", "=", "biergarten"} },
+                      { {"key1", "value1"} });
+    auto& stringTable = *dependencyProvider.getStringTable();
+    StyleProvider provider(*stylesheet, stringTable, 0);
+    Node node = ElementUtils::createElement<Node>(stringTable, 1, { std::make_pair("amenity", "biergarten") });
+
+    BOOST_CHECK(provider.forElement(node, zoomLevel).has(stringTable.getId("key1"), "value1"));
+    BOOST_CHECK_EQUAL(provider.getCacheStatistics().misses, 0);
+}
+
+BOOST_AUTO_TEST_CASE(GivenGradientDeclaration_WhenForElement_ThenGradientIsResolvedOnLoad)
+{
+    int zoomLevel = 1;
+    setSingleSelector(zoomLevel, zoomLevel, { "node" },
+                      { {"amenity", "=", "biergarten"} },
+                      { {"color", "gradient(#ff0000, #00ff00 50%, #0000ff)"} });
+    auto& stringTable = *dependencyProvider.getStringTable();
+    Node node = ElementUtils::createElement<Node>(stringTable, 1, { std::make_pair("amenity", "biergarten") });
+
+    Style style = styleProvider->forElement(node, zoomLevel);
+
+    const ColorGradient* gradient = style.getGradient("color");
+    BOOST_REQUIRE(gradient != nullptr);
+    BOOST_CHECK_EQUAL(gradient, &styleProvider->getGradient("gradient(#ff0000, #00ff00 50%, #0000ff)"));
+}
+
+BOOST_AUTO_TEST_CASE(GivenNewGradientKey_WhenGetGradientConcurrently_ThenReturnsSameInstance)
+{
+    setSingleSelector(1, 1, { "node" }, { {"amenity", "=", "biergarten"} });
+    std::vector<std::future<const ColorGradient*>> results;
+
+    for (int i = 0; i < 8; ++i) {
+        results.push_back(std::async(std::launch::async, [&]() {
+            const ColorGradient* gradient = nullptr;
+            for (int j = 0; j < 100; ++j)
+                gradient = &styleProvider->getGradient(j % 2 == 0 ? "red" : "#00ff00");
+            return gradient;
+        }));
+    }
+
+    const ColorGradient* expected = &styleProvider->getGradient("#00ff00");
+    for (auto& result : results)
+        BOOST_CHECK_EQUAL(result.get(), expected);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
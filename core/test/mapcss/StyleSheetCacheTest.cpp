@@ -0,0 +1,139 @@
+#include "config.hpp"
+#include "mapcss/MapCssParser.hpp"
+#include "mapcss/StyleSheetCache.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+using namespace utymap::mapcss;
+
+namespace {
+    const std::string StylePath = "cache_test.mapcss";
+
+    struct MapCss_StyleSheetCacheFixture
+    {
+        MapCss_StyleSheetCacheFixture() : cache("")
+        {
+        }
+
+        ~MapCss_StyleSheetCacheFixture()
+        {
+            std::remove(cache.getCachePath(StylePath).c_str());
+            std::remove(cache.getCachePath(TEST_MAPCSS_DEFAULT).c_str());
+            std::remove(StylePath.c_str());
+        }
+
+        static void writeFile(const std::string& path, const std::string& content)
+        {
+            std::ofstream file(path, std::ios::out | std::ios::trunc);
+            file << content;
+        }
+
+        static bool exists(const std::string& path)
+        {
+            return std::ifstream(path).good();
+        }
+
+        static void checkEqual(const StyleSheet& expected, const StyleSheet& actual)
+        {
+            BOOST_REQUIRE_EQUAL(expected.rules.size(), actual.rules.size());
+            for (std::size_t i = 0; i < expected.rules.size(); ++i) {
+                const auto& expectedRule = expected.rules[i];
+                const auto& actualRule = actual.rules[i];
+                BOOST_REQUIRE_EQUAL(expectedRule.selectors.size(), actualRule.selectors.size());
+                for (std::size_t j = 0; j < expectedRule.selectors.size(); ++j) {
+                    const auto& expectedSelector = expectedRule.selectors[j];
+                    const auto& actualSelector = actualRule.selectors[j];
+                    BOOST_CHECK(expectedSelector.names == actualSelector.names);
+                    BOOST_CHECK_EQUAL(expectedSelector.zoom.start, actualSelector.zoom.start);
+                    BOOST_CHECK_EQUAL(expectedSelector.zoom.end, actualSelector.zoom.end);
+                    BOOST_REQUIRE_EQUAL(expectedSelector.conditions.size(), actualSelector.conditions.size());
+                    for (std::size_t k = 0; k < expectedSelector.conditions.size(); ++k) {
+                        BOOST_CHECK_EQUAL(expectedSelector.conditions[k].key, actualSelector.conditions[k].key);
+                        BOOST_CHECK_EQUAL(expectedSelector.conditions[k].operation, actualSelector.conditions[k].operation);
+                        BOOST_CHECK_EQUAL(expectedSelector.conditions[k].value, actualSelector.conditions[k].value);
+                    }
+                }
+                BOOST_REQUIRE_EQUAL(expectedRule.declarations.size(), actualRule.declarations.size());
+                for (std::size_t j = 0; j < expectedRule.declarations.size(); ++j) {
+                    BOOST_CHECK_EQUAL(expectedRule.declarations[j].key, actualRule.declarations[j].key);
+                    BOOST_CHECK_EQUAL(expectedRule.declarations[j].value, actualRule.declarations[j].value);
+                }
+            }
+
+            BOOST_REQUIRE_EQUAL(expected.textures.size(), actual.textures.size());
+            for (std::size_t i = 0; i < expected.textures.size(); ++i) {
+                BOOST_CHECK_EQUAL(expected.textures[i].index(), actual.textures[i].index());
+                BOOST_REQUIRE_EQUAL(expected.textures[i].groups().size(), actual.textures[i].groups().size());
+                for (const auto& pair : expected.textures[i].groups()) {
+                    const auto& expectedRegions = pair.second.regions();
+                    const auto& actualRegions = actual.textures[i].get(pair.first).regions();
+                    BOOST_REQUIRE_EQUAL(expectedRegions.size(), actualRegions.size());
+                    for (std::size_t j = 0; j < expectedRegions.size(); ++j) {
+                        BOOST_CHECK_EQUAL(expectedRegions[j].x, actualRegions[j].x);
+                        BOOST_CHECK_EQUAL(expectedRegions[j].y, actualRegions[j].y);
+                        BOOST_CHECK_EQUAL(expectedRegions[j].width, actualRegions[j].width);
+                        BOOST_CHECK_EQUAL(expectedRegions[j].height, actualRegions[j].height);
+                    }
+                }
+            }
+
+            BOOST_REQUIRE_EQUAL(expected.lsystems.size(), actual.lsystems.size());
+            for (const auto& pair : expected.lsystems) {
+                const auto& lsystem = actual.lsystems.at(pair.first);
+                BOOST_CHECK_EQUAL(pair.second.generations, lsystem.generations);
+                BOOST_CHECK_EQUAL(pair.second.angle, lsystem.angle);
+                BOOST_CHECK_EQUAL(pair.second.scale, lsystem.scale);
+                BOOST_CHECK_EQUAL(pair.second.axiom.size(), lsystem.axiom.size());
+                BOOST_CHECK_EQUAL(pair.second.productions.size(), lsystem.productions.size());
+            }
+        }
+
+        StyleSheetCache cache;
+    };
+}
+
+BOOST_FIXTURE_TEST_SUITE(MapCss_StyleSheetCache, MapCss_StyleSheetCacheFixture)
+
+BOOST_AUTO_TEST_CASE(GivenDefaultStylesheet_WhenGetFromCache_ThenReturnsSameAsParsed)
+{
+    std::ifstream styleFile(TEST_MAPCSS_DEFAULT);
+    std::string stylePath = TEST_MAPCSS_DEFAULT;
+    StyleSheet expected = MapCssParser(stylePath.substr(0, stylePath.find_last_of("\\/") + 1)).parse(styleFile);
+
+    StyleSheet parsed = cache.get(TEST_MAPCSS_DEFAULT);
+    BOOST_CHECK(exists(cache.getCachePath(TEST_MAPCSS_DEFAULT)));
+    StyleSheet cached = cache.get(TEST_MAPCSS_DEFAULT);
+
+    checkEqual(expected, parsed);
+    checkEqual(expected, cached);
+    BOOST_CHECK(expected.sources == cached.sources);
+}
+
+BOOST_AUTO_TEST_CASE(GivenChangedSource_WhenGetFromCache_ThenStylesheetIsParsedAgain)
+{
+    writeFile(StylePath, "way|z16[highway] { width: 1m; }");
+    cache.get(StylePath);
+
+    writeFile(StylePath, "way|z16[highway] { width: 2m; } area|z16[building] { height: 10; }");
+    StyleSheet stylesheet = cache.get(StylePath);
+
+    BOOST_REQUIRE_EQUAL(stylesheet.rules.size(), 2);
+    BOOST_CHECK_EQUAL(stylesheet.rules[0].declarations[0].value, "2m");
+}
+
+BOOST_AUTO_TEST_CASE(GivenCorruptedCacheFile_WhenGetFromCache_ThenStylesheetIsParsed)
+{
+    writeFile(StylePath, "way|z16[highway] { width: 1m; }");
+    cache.get(StylePath);
+    writeFile(cache.getCachePath(StylePath), "corrupted");
+
+    StyleSheet stylesheet = cache.get(StylePath);
+
+    BOOST_REQUIRE_EQUAL(stylesheet.rules.size(), 1);
+    BOOST_CHECK_EQUAL(stylesheet.rules[0].declarations[0].value, "1m");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
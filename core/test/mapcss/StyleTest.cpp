@@ -62,5 +62,44 @@ BOOST_AUTO_TEST_CASE(GivenNegativeValueInMeters_WhenGetValue_ThenReturnExpectedV
     BOOST_CHECK_EQUAL(width, -1);
 }
 
+BOOST_AUTO_TEST_CASE(GivenValueInPercents_WhenGetValueByKeyId_ThenReturnRelativeValue)
+{
+    int lod = 16;
+    auto& stringTable = *dependencyProvider.getStringTable();
+    Way way = ElementUtils::createElement<Way>(stringTable,
+        0, { std::make_pair("percent", "") }, { { 52.52975, 13.38810 } });
+    Style style = dependencyProvider.getStyleProvider(stylesheet)->forElement(way, lod);
+
+    double width = style.getValue(stringTable.getId("width"), 200);
+
+    BOOST_CHECK_EQUAL(width, 20);
+    BOOST_CHECK_EQUAL(width, style.getValue("width", 200));
+}
+
+BOOST_AUTO_TEST_CASE(GivenValueInMeters_WhenGetValueByKeyIdWithBoundingBox_ThenReturnSameAsByKey)
+{
+    int lod = 16;
+    auto& stringTable = *dependencyProvider.getStringTable();
+    Way way = ElementUtils::createElement<Way>(stringTable,
+        0, { std::make_pair("meters", "") }, { { 52.52975, 13.38810 } });
+    Style style = dependencyProvider.getStyleProvider(stylesheet)->forElement(way, lod);
+
+    double width = style.getValue(stringTable.getId("width"), boundingBox);
+
+    BOOST_CHECK_EQUAL(width, style.getValue("width", boundingBox));
+    BOOST_CHECK_EQUAL(style.getValue(stringTable.getId("width")), 10);
+}
+
+BOOST_AUTO_TEST_CASE(GivenMissingKey_WhenGetValueByKeyId_ThenReturnZero)
+{
+    int lod = 16;
+    auto& stringTable = *dependencyProvider.getStringTable();
+    Way way = ElementUtils::createElement<Way>(stringTable,
+        0, { std::make_pair("meters", "") }, { { 52.52975, 13.38810 } });
+    Style style = dependencyProvider.getStyleProvider(stylesheet)->forElement(way, lod);
+
+    BOOST_CHECK_EQUAL(style.getValue(stringTable.getId("height")), 0);
+}
+
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -5,12 +5,18 @@
 #include "builders/MeshBuilder.hpp"
 
 #include <boost/test/unit_test.hpp>
+#include "test_utils/AllocationCounter.hpp"
+
+#include <cmath>
+#include <limits>
+#include <map>
 
 using namespace ClipperLib;
 using namespace utymap::builders;
 using namespace utymap::heightmap;
 using namespace utymap::mapcss;
 using namespace utymap::math;
+using namespace utymap::tests;
 
 namespace {
     typedef Vector2 DPoint;
@@ -26,6 +32,40 @@ namespace {
         {
         }
 
+        /// Returns signed area of all triangles projected to xy plane.
+        static double getArea(const Mesh& mesh)
+        {
+            double area = 0;
+            for (std::size_t i = 0; i < mesh.triangles.size(); i += 3) {
+                auto a = mesh.triangles[i] * 3, b = mesh.triangles[i + 1] * 3, c = mesh.triangles[i + 2] * 3;
+                area += ((mesh.vertices[b] - mesh.vertices[a]) * (mesh.vertices[c + 1] - mesh.vertices[a + 1]) -
+                         (mesh.vertices[c] - mesh.vertices[a]) * (mesh.vertices[b + 1] - mesh.vertices[a + 1])) / 2;
+            }
+            return area;
+        }
+
+        /// Returns length of edges which belong to one triangle only.
+        static double getBorderLength(const Mesh& mesh)
+        {
+            std::map<std::pair<std::pair<double, double>, std::pair<double, double>>, int> edges;
+            for (std::size_t i = 0; i < mesh.triangles.size(); i += 3) {
+                for (std::size_t j = 0; j < 3; ++j) {
+                    auto a = mesh.triangles[i + j] * 3, b = mesh.triangles[i + (j + 1) % 3] * 3;
+                    auto pa = std::make_pair(mesh.vertices[a], mesh.vertices[a + 1]);
+                    auto pb = std::make_pair(mesh.vertices[b], mesh.vertices[b + 1]);
+                    ++edges[std::make_pair(std::min(pa, pb), std::max(pa, pb))];
+                }
+            }
+
+            double length = 0;
+            for (const auto& edge : edges) {
+                if (edge.second == 1)
+                    length += std::hypot(edge.first.first.first - edge.first.second.first,
+                                         edge.first.first.second - edge.first.second.second);
+            }
+            return length;
+        }
+
         FlatElevationProvider eleProvider;
         MeshBuilder builder;
         ColorGradient gradient;
@@ -82,6 +122,28 @@ BOOST_AUTO_TEST_CASE(GivenPolygonWithHole_WhenAddPolygon_ThenRefinesCorrectly)
     BOOST_CHECK(mesh.triangles.size() > 0);
 }
 
+BOOST_AUTO_TEST_CASE(GivenPolygonWithHole_WhenAddPolygonAgain_ThenDoesNotAllocate)
+{
+    Mesh mesh("");
+    Polygon polygon(8, 1);
+    geometryOptions.area = 1;
+    geometryOptions.elevation = std::numeric_limits<double>::lowest();
+    geometryOptions.eleNoiseFreq = 0.1;
+    polygon.addContour(std::vector<DPoint> { DPoint(0, 0), DPoint(10, 0), DPoint(10, 10), DPoint(0, 10) });
+    polygon.addHole(std::vector<DPoint> { DPoint(3, 3), DPoint(6, 3), DPoint(6, 6), DPoint(3, 6) });
+    // warm up scratch buffers and mesh capacity
+    builder.addPolygon(mesh, polygon, geometryOptions, appearanceOptions);
+    auto vertexCount = mesh.vertices.size();
+    mesh.clear();
+
+    auto allocations = AllocationCounter::count();
+    builder.addPolygon(mesh, polygon, geometryOptions, appearanceOptions);
+    allocations = AllocationCounter::count() - allocations;
+
+    BOOST_CHECK_EQUAL(allocations, 0);
+    BOOST_CHECK_EQUAL(mesh.vertices.size(), vertexCount);
+}
+
 BOOST_AUTO_TEST_CASE(GivenPolygonProcessedByGridSplitter_WhenAddPolygon_ThenRefinesCorrectly)
 {
     std::vector<Vector2> contour;
@@ -156,4 +218,34 @@ BOOST_AUTO_TEST_CASE(GivenSimpleSquareWithScale_WhenAddPolygon_ThenScaledTexture
     BOOST_CHECK_EQUAL(mesh.vertices.size() * 2 / 3, mesh.uvs.size());
 }
 
+BOOST_AUTO_TEST_CASE(GivenPolygonWithHole_WhenAddGrid_ThenTrianglesCoverPolygonOnce)
+{
+    Polygon polygon(8, 1);
+    polygon.addContour({ { 0.3, 0.3 }, { 10.3, 0.7 }, { 9.7, 10.3 }, { 0.1, 9.8 } });
+    polygon.addHole({ { 3, 3 }, { 6, 3 }, { 6, 6 }, { 3, 6 } });
+    geometryOptions.area = 0.5;
+    Mesh gridMesh("");
+    Mesh triangleMesh("");
+
+    builder.addGrid(gridMesh, polygon, geometryOptions, appearanceOptions);
+    builder.addPolygon(triangleMesh, polygon, geometryOptions, appearanceOptions);
+
+    BOOST_CHECK_CLOSE(getArea(gridMesh), getArea(triangleMesh), 1E-3);
+    BOOST_CHECK_CLOSE(getBorderLength(gridMesh), getBorderLength(triangleMesh), 1E-3);
+    BOOST_CHECK_EQUAL(gridMesh.vertices.size() / 3, gridMesh.colors.size());
+    BOOST_CHECK_EQUAL(gridMesh.vertices.size() * 2 / 3, gridMesh.uvs.size());
+}
+
+BOOST_AUTO_TEST_CASE(GivenPolygonSmallerThanCell_WhenAddGrid_ThenTrianglesCoverPolygon)
+{
+    Polygon polygon(4, 0);
+    polygon.addContour({ { 1.1, 1.1 }, { 1.4, 1.1 }, { 1.4, 1.4 }, { 1.1, 1.4 } });
+    geometryOptions.area = 2;
+    Mesh mesh("");
+
+    builder.addGrid(mesh, polygon, geometryOptions, appearanceOptions);
+
+    BOOST_CHECK_CLOSE(std::abs(getArea(mesh)), 0.09, 1E-3);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
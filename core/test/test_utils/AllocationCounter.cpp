@@ -0,0 +1,30 @@
+#include "test_utils/AllocationCounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<std::size_t> allocations(0);
+
+    void* allocate(std::size_t size)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        if (void* ptr = std::malloc(size == 0 ? 1 : size))
+            return ptr;
+        throw std::bad_alloc();
+    }
+}
+
+std::size_t utymap::tests::AllocationCounter::count()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size) { return allocate(size); }
+
+void* operator new[](std::size_t size) { return allocate(size); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
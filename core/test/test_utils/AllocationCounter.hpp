@@ -0,0 +1,19 @@
+#ifndef TEST_ALLOCATIONCOUNTER_HPP_DEFINED
+#define TEST_ALLOCATIONCOUNTER_HPP_DEFINED
+
+#include <cstddef>
+
+namespace utymap { namespace tests {
+
+/// Counts allocations made via global operator new in test executable.
+/// NOTE memory allocated by C libraries with malloc is not counted.
+class AllocationCounter final
+{
+public:
+    /// Returns amount of allocations made since test executable has started.
+    static std::size_t count();
+};
+
+}}
+
+#endif // TEST_ALLOCATIONCOUNTER_HPP_DEFINED
@@ -3,6 +3,8 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <cstdlib>
+
 using namespace utymap::mapcss;
 using namespace utymap::utils;
 
@@ -58,4 +60,35 @@ BOOST_AUTO_TEST_CASE(GivenColorString_WhenParseGradient_ThenReturnValid)
     BOOST_CHECK_EQUAL(gradient->evaluate(0), 0xEC8859FF);
 }
 
+BOOST_AUTO_TEST_CASE(GivenGradient_WhenLookupBounds_ThenReturnEvaluatedColors)
+{
+    auto gradient = GradientUtils::parseGradient("gradient(#0fffff, #099999 50%, #033333 70%, #000000)");
+
+    BOOST_CHECK_EQUAL(gradient->lookup(0), gradient->evaluate(0));
+    BOOST_CHECK_EQUAL(gradient->lookup(1), gradient->evaluate(1));
+    BOOST_CHECK_EQUAL(gradient->lookup(-1), gradient->evaluate(0));
+    BOOST_CHECK_EQUAL(gradient->lookup(2), gradient->evaluate(1));
+}
+
+BOOST_AUTO_TEST_CASE(GivenPoints_WhenGetColors_ThenColorsAreCloseToSingleEvaluation)
+{
+    auto gradient = GradientUtils::parseGradient("gradient(#0fffff, #099999 50%, #033333 70%, #000000)");
+    const std::size_t count = 300;
+    std::vector<double> points;
+    for (std::size_t i = 0; i < count; ++i) {
+        points.push_back(52.53 + i * 0.0001);
+        points.push_back(13.38 + i * 0.0002);
+    }
+    std::vector<int> colors(count);
+
+    GradientUtils::getColors(*gradient, points.data(), count, 0.1, colors.data());
+
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint32_t expected = static_cast<std::uint32_t>(GradientUtils::getColor(*gradient, points[i * 2], points[i * 2 + 1], 0.1));
+        std::uint32_t actual = static_cast<std::uint32_t>(colors[i]);
+        for (int shift = 0; shift < 32; shift += 8)
+            BOOST_CHECK_LE(std::abs(static_cast<int>((expected >> shift) & 0xFF) - static_cast<int>((actual >> shift) & 0xFF)), 2);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,86 @@
+#include "utils/LruCache.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <stdexcept>
+
+using namespace utymap::utils;
+
+namespace {
+    typedef LruCache<int, int> Cache;
+
+    struct Utils_LruCacheFixture
+    {
+        Utils_LruCacheFixture() : cache(2), loads(0)
+        {
+        }
+
+        /// Creates value for given key failing for negative ones.
+        std::shared_ptr<int> create(int key)
+        {
+            if (key < 0)
+                throw std::domain_error("Cannot load value.");
+
+            ++loads;
+            return std::make_shared<int>(key * 10);
+        }
+
+        Cache::ValuePtr get(int key)
+        {
+            return cache.get(key, [&](int k) { return create(k); });
+        }
+
+        Cache cache;
+        int loads;
+    };
+}
+
+BOOST_FIXTURE_TEST_SUITE(Utils_LruCache, Utils_LruCacheFixture)
+
+BOOST_AUTO_TEST_CASE(GivenLoadedValue_WhenGet_ThenFactoryIsNotCalled)
+{
+    get(1);
+
+    int value = *get(1);
+
+    BOOST_CHECK_EQUAL(value, 10);
+    BOOST_CHECK_EQUAL(loads, 1);
+}
+
+BOOST_AUTO_TEST_CASE(GivenFullCache_WhenGetNewValue_ThenLeastRecentlyUsedIsEvictedAndReleased)
+{
+    std::weak_ptr<const int> first = get(1);
+    std::weak_ptr<const int> second = get(2);
+    get(1);
+
+    get(3);
+
+    BOOST_CHECK_EQUAL(cache.size(), 2);
+    BOOST_CHECK(!first.expired());
+    BOOST_CHECK(second.expired());
+}
+
+BOOST_AUTO_TEST_CASE(GivenPreloadWhichThrows_WhenGet_ThenCacheIsNotChanged)
+{
+    Cache cache(3);
+    auto factory = [&](int k) { return create(k); };
+    cache.get(1, factory);
+
+    BOOST_CHECK_THROW(cache.get(2, factory, [](const Cache::Loader& load) {
+        load(-1);
+        load(3);
+    }), std::domain_error);
+    std::size_t size = cache.size();
+    cache.get(1, factory);
+    cache.get(2, factory);
+    cache.get(3, factory);
+    cache.get(4, factory);
+
+    BOOST_CHECK_EQUAL(size, 1);
+    BOOST_CHECK_EQUAL(cache.size(), 3);
+    BOOST_CHECK_EQUAL(*cache.get(4, factory), 40);
+    BOOST_CHECK_EQUAL(loads, 5);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
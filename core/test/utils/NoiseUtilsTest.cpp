@@ -2,6 +2,8 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <vector>
+
 using namespace utymap::utils;
 
 namespace {
@@ -18,4 +20,15 @@ BOOST_AUTO_TEST_CASE(GivenTestValues_WhenPerlin3d_ThenReturnExpectedValues)
     BOOST_CHECK_CLOSE(NoiseUtils::perlin3D(52, 120, 13, 0.12), -0.1014592, Tolerance);
 }
 
+BOOST_AUTO_TEST_CASE(GivenPoints_WhenPerlin2dBatch_ThenReturnSameValuesAsSingleCalls)
+{
+    std::vector<double> points = { 1, 1, 10, 42, 52.5, 13.4, -7, 120 };
+    std::vector<double> result(points.size() / 2);
+
+    NoiseUtils::perlin2D(points.data(), result.size(), 0.1, result.data());
+
+    for (std::size_t i = 0; i < result.size(); ++i)
+        BOOST_CHECK_EQUAL(result[i], NoiseUtils::perlin2D(points[i * 2], points[i * 2 + 1], 0.1));
+}
+
 BOOST_AUTO_TEST_SUITE_END()